@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 namespace lpm
@@ -33,8 +34,25 @@ namespace lpm
 
         inline static unsigned FRAME_RATE = 30;
 
+        inline static const char* RENDER_SCALE = "window"; //< "window", "auto" from a fill-rate probe, or a multiple "1" to "4"
+        inline static bool RENDER_SCALE_SMOOTH = true;     //< Linear upscale of scenes, false for nearest pixel
+        inline static bool RENDER_THREAD       = false;    //< Draw scenes in a render thread, shown one frame late
+
         static constexpr unsigned BACKGROUND_TEX_SIZE_X = 640;
         static constexpr unsigned BACKGROUND_TEX_SIZE_Y = 480;
 
+        inline static const char* ROOM_DATABASE_FILE = "rooms.bin";    //< Compiled by RoomCompiler from rooms.json
+        inline static const char* ASSET_TIERS_FILE   = "tiers.json";   //< Resolution variants of images
+        inline static const char* TEXTURE_CACHE_DIR  = "cache";        //< Decoded images, nullptr to always decode
+        inline static const char* SPLASH_COMPOSITOR  = "auto";         //< "gpu", "cpu", or "auto" for cpu on software GL
+
+        inline static const char* NETWORK_RECORD_FILE    = nullptr;   //< Record incoming network events into this file
+        inline static const char* NETWORK_REPLAY_FILE    = nullptr;   //< Replace network with a recorded session
+        inline static float NETWORK_REPLAY_SPEED         = 1.f;       //< Replay speed, 0 as fast as possible
+        inline static const char* NETWORK_TELEMETRY_FILE = nullptr;   //< Dump network telemetry as JSON on exit
+        inline static unsigned DEBUG_CROWD_PLAYERS       = 0;         //< Fake players simulated by DebugNetwork
+
+        static constexpr size_t MAX_CHAT_MESSAGE_LENGTH = 512;        //< Longer chat messages are truncated, sent or received
+
     };
 }
@@ -34,6 +34,12 @@ namespace lpm
     class Cursor;
     class SceneManager;
     class INetwork;
+    class ChatLog;
+    class AsyncLoader;
+    class AssetTiers;
+    class RenderScale;
+    class RenderThread;
+    class NetworkRecorder;
     class Scene;
 
     class Engine
@@ -54,12 +60,26 @@ namespace lpm
         [[nodiscard]] const Resources& getResources() const;
         [[nodiscard]] const Internationalization& getI18N() const;
         [[nodiscard]] Cursor& getCursor();
+        [[nodiscard]] INetwork& getNetwork();
+        [[nodiscard]] ChatLog& getChat();
+        [[nodiscard]] AsyncLoader& getLoader();
+        [[nodiscard]] const AssetTiers& getTiers() const;
         [[nodiscard]] sf::Vector2i getMousePosition() const;
         [[nodiscard]] sf::Vector2u getWindowSize() const;
 
+        /**
+         * Get window pixels per scene unit, as scenes are fit into the window
+         */
+        [[nodiscard]] float getViewportScale() const;
+
     private:
         void processEvents(sf::Event& event);
 
+        static Pointer<INetwork> createNetwork();
+        static Pointer<AssetTiers> createTiers();
+        Pointer<RenderScale> createRenderScale();
+        Pointer<RenderThread> createRenderThread();
+
         #ifndef NDEBUG
         void drawFPS(float deltaSeconds);
         #endif
@@ -68,6 +88,12 @@ namespace lpm
         sf::RenderWindow window_;                               //< SFML class to draw OS window
 
         Pointer<INetwork> network_;                             //< Network interface
+        Pointer<NetworkRecorder> recorder_;                     //< Records network traffic when enabled
+        Pointer<ChatLog> chat_;                                 //< Chat history received from network
+        Pointer<AsyncLoader> loader_;                           //< Decodes assets in background
+        Pointer<AssetTiers> tiers_;                             //< Resolution variants of images
+        Pointer<RenderScale> renderScale_;                      //< Scene target, null draws into window
+        Pointer<RenderThread> renderThread_;                    //< Draws scenes in parallel, replaces renderScale_
         Pointer<sf::Clock> clock_;                              //< SFML clock
         Pointer<Cursor> cursor_;                                //< Cursor class
         Pointer<Internationalization> internationalization_;    //< i18n pointer
@@ -21,6 +21,8 @@
 
 #include <Engine.hpp>
 
+#include <algorithm>
+#include <charconv>
 #include <iostream>
 
 #include <SFML/Graphics.hpp>
@@ -32,7 +34,16 @@
 
 #include <widgets/Cursor.hpp>
 #include <network/DebugNetwork.hpp>
+#include <network/ReplayNetwork.hpp>
+#include <network/NetworkRecorder.hpp>
+#include <network/NetworkLog.hpp>
+#include <chat/ChatLog.hpp>
+#include <components/AspectRatio.hpp>
+#include <components/AssetTiers.hpp>
+#include <components/AsyncLoader.hpp>
 #include <components/Internationalization.hpp>
+#include <components/RenderScale.hpp>
+#include <scene/RenderThread.hpp>
 #include <Resources.hpp>
 #include <Configuration.hpp>
 
@@ -47,16 +58,38 @@ using namespace lpm;
 
 Engine::Engine()
 : window_(sf::VideoMode(Configuration::WINDOW_SIZE_X, Configuration::WINDOW_SIZE_Y), Configuration::WINWDOW_TITLE)
-, network_(std::make_unique<DebugNetwork>())
+, network_(createNetwork())
+, chat_(std::make_unique<ChatLog>())
+, loader_(std::make_unique<AsyncLoader>())
+, tiers_(createTiers())
 , clock_(std::make_unique<sf::Clock>())
 , cursor_(std::make_unique<Cursor>())
 , internationalization_(std::make_unique<Internationalization>())
 , gui_(std::make_unique<tgui::Gui>())
 
 {
+    chat_->listen(*network_);
+
+    if(Configuration::NETWORK_RECORD_FILE)
+    {
+        try
+        {
+            recorder_ = std::make_unique<NetworkRecorder>(*network_, Configuration::NETWORK_RECORD_FILE);
+        }
+        catch(const network_log_exception&)
+        {
+            std::cerr << "Can't record network into \042" << Configuration::NETWORK_RECORD_FILE << "\042\n";
+        }
+    }
+
+    network_->init();
+
     window_.setFramerateLimit(Configuration::FRAME_RATE);
     window_.setMouseCursorVisible(false);
 
+    renderScale_ = createRenderScale();
+    renderThread_ = createRenderThread();
+
     std::bit_cast<tgui::Gui*>(gui_.get())->setWindow(window_);
 
     //~===================================================================
@@ -116,6 +149,9 @@ void Engine::run()
         processEvents(event);
         std::bit_cast<tgui::Gui*>(gui_.get())->handleEvent(event);
 
+        network_->tick(time.asSeconds());
+        if(recorder_) recorder_->tick();
+
         ImGui::SFML::Update(window_, time);
 
         scene_->tick(time.asSeconds());
@@ -123,12 +159,29 @@ void Engine::run()
 
         #ifndef NDEBUG
         drawFPS(time.asSeconds());
+        network_->drawDebug();
+        network_->getTelemetry().drawImGui();
         #endif
 
         //ImGui::ShowDemoWindow();
 
         window_.clear();
-        window_.draw(*scene_);
+        if(renderThread_)
+        {
+            // Next tick and this frame are drawn meanwhile, the window shows the previous one
+            renderThread_->submit(*scene_);
+            renderThread_->present(window_);
+        }
+        else if(renderScale_)
+        {
+            renderScale_->begin().draw(*scene_);
+            renderScale_->end();
+            renderScale_->present(window_);
+        }
+        else
+        {
+            window_.draw(*scene_);
+        }
         gui_->draw();
         ImGui::SFML::Render(window_);
         window_.draw(getCursor());
@@ -137,6 +190,7 @@ void Engine::run()
 
         if(scene_->isPendingToDestroy())
         {
+            if(renderThread_) renderThread_->wait();
             (void)scene_.release();
             if(!scenePendingToLoad_.empty())
             {
@@ -153,7 +207,15 @@ void Engine::run()
         }
     }
 
+    // Stop drawing the scene before anything it uses is destroyed
+    renderThread_.reset();
+
     ImGui::SFML::Shutdown();
+
+    if(Configuration::NETWORK_TELEMETRY_FILE && !network_->getTelemetry().dump(Configuration::NETWORK_TELEMETRY_FILE))
+    {
+        std::cerr << "Can't write network telemetry into \042" << Configuration::NETWORK_TELEMETRY_FILE << "\042\n";
+    }
 }
 
 void Engine::stop()
@@ -181,6 +243,89 @@ void Engine::loadScene(std::string_view name)
     }
 }
 
+Engine::Pointer<INetwork> Engine::createNetwork()
+{
+    if(Configuration::NETWORK_REPLAY_FILE)
+    {
+        try
+        {
+            return std::make_unique<ReplayNetwork>(Configuration::NETWORK_REPLAY_FILE, Configuration::NETWORK_REPLAY_SPEED);
+        }
+        catch(const network_log_exception&)
+        {
+            std::cerr << "Can't replay network from \042" << Configuration::NETWORK_REPLAY_FILE << "\042\n";
+        }
+    }
+
+    DebugNetwork::CrowdSettings crowd;
+    crowd.players = Configuration::DEBUG_CROWD_PLAYERS;
+    return std::make_unique<DebugNetwork>(crowd);
+}
+
+Engine::Pointer<AssetTiers> Engine::createTiers()
+{
+    try
+    {
+        return std::make_unique<AssetTiers>(Configuration::ASSET_TIERS_FILE);
+    }
+    catch(const asset_tiers_exception&)
+    {
+        std::cerr << "Can't read asset tiers from \042" << Configuration::ASSET_TIERS_FILE << "\042\n";
+    }
+
+    return std::make_unique<AssetTiers>();
+}
+
+Engine::Pointer<RenderScale> Engine::createRenderScale()
+{
+    const std::string_view mode = Configuration::RENDER_SCALE ? Configuration::RENDER_SCALE : "window";
+    if(mode == "window") return nullptr;
+
+    unsigned maxScale = 0;
+    if(mode == "auto")
+    {
+        maxScale = RenderScale::probe(RenderScale::MAX_SCALE, Configuration::FRAME_RATE);
+    }
+    else if(const auto [end, error] = std::from_chars(mode.data(), mode.data() + mode.size(), maxScale);
+            error != std::errc() || end != mode.data() + mode.size() || maxScale < 1 || maxScale > RenderScale::MAX_SCALE)
+    {
+        std::cerr << "Invalid render scale \042" << mode << "\042, drawing at window resolution\n";
+        return nullptr;
+    }
+
+    try
+    {
+        return std::make_unique<RenderScale>(maxScale, Configuration::RENDER_SCALE_SMOOTH, window_.getSize());
+    }
+    catch(const render_scale_exception&)
+    {
+        std::cerr << "Can't create scene target, drawing at window resolution\n";
+    }
+
+    return nullptr;
+}
+
+Engine::Pointer<RenderThread> Engine::createRenderThread()
+{
+    if(!Configuration::RENDER_THREAD) return nullptr;
+
+    // Thread draws into its own targets, scaled as renderScale_ would be, or as the window if it draws into it
+    const unsigned maxScale = renderScale_ ? renderScale_->getMaxScale() : RenderScale::MAX_SCALE;
+
+    try
+    {
+        auto renderThread = std::make_unique<RenderThread>(maxScale, Configuration::RENDER_SCALE_SMOOTH, window_.getSize());
+        renderScale_.reset();
+        return renderThread;
+    }
+    catch(const render_scale_exception&)
+    {
+        std::cerr << "Can't create render thread targets, drawing in main thread\n";
+    }
+
+    return nullptr;
+}
+
 void Engine::processEvents(sf::Event& event)
 {
     while (window_.pollEvent(event))
@@ -202,6 +347,31 @@ void Engine::processEvents(sf::Event& event)
                     static_cast<float>(event.size.width),
                     static_cast<float>(event.size.height)
                 }));
+                if(renderThread_)
+                {
+                    try
+                    {
+                        renderThread_->resize(window_.getSize());
+                    }
+                    catch(const render_scale_exception&)
+                    {
+                        std::cerr << "Can't resize render thread targets, drawing in main thread\n";
+                        renderThread_.reset();
+                    }
+                }
+                else if(renderScale_)
+                {
+                    try
+                    {
+                        renderScale_->resize(window_.getSize());
+                    }
+                    catch(const render_scale_exception&)
+                    {
+                        std::cerr << "Can't resize scene target, drawing at window resolution\n";
+                        renderScale_.reset();
+                    }
+                }
+                if(scene_) scene_->resize();
                 break;
         }
     }
@@ -212,6 +382,12 @@ void Engine::drawFPS(float deltaSeconds)
 {
     ImGui::Begin("Debug - FPS");
     ImGui::LabelText("FPS", "%d", static_cast<unsigned>(1.f / deltaSeconds));
+
+    const auto& stats = scene_->getRenderStats();
+    ImGui::LabelText("Draw calls", "%u", stats.drawCalls);
+    ImGui::LabelText("State changes", "%u (texture %u, shader %u, blend %u)",
+                     stats.getStateChanges(), stats.textureChanges, stats.shaderChanges, stats.blendChanges);
+    ImGui::LabelText("Culled nodes", "%zu", scene_->getCulledCount());
     ImGui::End();
 }
 #endif
@@ -231,6 +407,26 @@ Cursor& Engine::getCursor()
     return *cursor_;
 }
 
+INetwork& Engine::getNetwork()
+{
+    return *network_;
+}
+
+ChatLog& Engine::getChat()
+{
+    return *chat_;
+}
+
+AsyncLoader& Engine::getLoader()
+{
+    return *loader_;
+}
+
+const AssetTiers& Engine::getTiers() const
+{
+    return *tiers_;
+}
+
 sf::Vector2i Engine::getMousePosition() const
 {
     return sf::Mouse::getPosition(window_);
@@ -241,6 +437,22 @@ sf::Vector2u Engine::getWindowSize() const
     return window_.getSize();
 }
 
+float Engine::getViewportScale() const
+{
+    const auto viewport = AspectRatio::getViewportSize(
+        {Configuration::BACKGROUND_TEX_SIZE_X, Configuration::BACKGROUND_TEX_SIZE_Y},
+        window_.getSize(),
+        AspectRatio::EAspectRatioRule::FitToParent
+    );
+
+    const float scale = viewport.x / static_cast<float>(Configuration::BACKGROUND_TEX_SIZE_X);
+
+    // Scene target never shows more pixels than its own
+    if(renderThread_) return std::min(scale, static_cast<float>(renderThread_->getScale()));
+    if(renderScale_) return std::min(scale, static_cast<float>(renderScale_->getScale()));
+    return scale;
+}
+
 
 
 
@@ -269,8 +481,20 @@ extern "C" void handle_signals(int signal_number)
     std::cerr << "Ungracefully exit: " << signType << '(' << signal_number << ')' << '\n';
 }
 
-int main(const int, const char**)
+int main(const int argc, const char** argv)
 {
+    for(int i = 1; i + 1 < argc; i++)
+    {
+        const std::string_view arg = argv[i];
+        if(arg == "--record")            Configuration::NETWORK_RECORD_FILE  = argv[++i];
+        else if(arg == "--replay")       Configuration::NETWORK_REPLAY_FILE  = argv[++i];
+        else if(arg == "--replay-speed") Configuration::NETWORK_REPLAY_SPEED = std::strtof(argv[++i], nullptr);
+        else if(arg == "--telemetry")    Configuration::NETWORK_TELEMETRY_FILE = argv[++i];
+        else if(arg == "--render-scale") Configuration::RENDER_SCALE = argv[++i];
+        else if(arg == "--render-thread") Configuration::RENDER_THREAD = std::string_view(argv[++i]) != "0";
+        else if(arg == "--crowd")        Configuration::DEBUG_CROWD_PLAYERS  = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+    }
+
     signal(SIGILL,   &handle_signals);
     signal(SIGFPE,   &handle_signals);
     signal(SIGSEGV,  &handle_signals);
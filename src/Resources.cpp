@@ -25,12 +25,14 @@
 #include <SFML/Graphics/Font.hpp>
 #include <SFML/Audio/SoundBuffer.hpp>
 
+#include <components/TextureCache.hpp>
+
 using namespace lpm;
 
 Resources::Resources()
 {
     auto createTexture = [&](std::string_view key, std::string_view fileName){
-        if(auto asset = std::make_unique<sf::Texture>(); asset->loadFromFile(fileName.data()))
+        if(auto asset = std::make_unique<sf::Texture>(); TextureCache::loadTexture(fileName, *asset))
         {
             textures_.try_emplace(key.data(), std::move(asset));
         }
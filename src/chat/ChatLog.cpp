@@ -0,0 +1,219 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "ChatLog.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include <components/Hash.hpp>
+#include <network/INetwork.hpp>
+
+using namespace lpm;
+
+namespace
+{
+    constexpr uint8_t NO_SENDER = 0;
+}
+
+ChatLog::ChatLog(size_t capacity, size_t arenaSize)
+: messages_(capacity)
+, arena_(std::make_unique<char[]>(arenaSize))
+, arenaSize_(arenaSize)
+, senders_(MAX_SENDERS)
+{
+    assert(arenaSize_ >= MAX_MESSAGE_LENGTH && "ChatLog arena can't hold a single message");
+
+    // Sender 0 is reserved for messages without sender (global and room messages)
+    senders_[NO_SENDER].references = std::numeric_limits<uint32_t>::max();
+}
+
+ChatLog::~ChatLog()
+{
+    stopListening();
+}
+
+void ChatLog::listen(INetwork& network)
+{
+    stopListening();
+    network_ = &network;
+
+    auto& events = network.getEvents();
+    subscriptions_ = {
+        events.subscribe<NetworkEvent::GlobalMessage>(NetworkEventBus::Handler<NetworkEvent::GlobalMessage>::bind<&ChatLog::onGlobalMessage>(this)),
+        events.subscribe<NetworkEvent::RoomMessage>(NetworkEventBus::Handler<NetworkEvent::RoomMessage>::bind<&ChatLog::onRoomMessage>(this)),
+        events.subscribe<NetworkEvent::PlayerMessage>(NetworkEventBus::Handler<NetworkEvent::PlayerMessage>::bind<&ChatLog::onPlayerMessage>(this)),
+        events.subscribe<NetworkEvent::PrivateMessage>(NetworkEventBus::Handler<NetworkEvent::PrivateMessage>::bind<&ChatLog::onPrivateMessage>(this))
+    };
+}
+
+void ChatLog::stopListening()
+{
+    if(!network_) return;
+
+    for(const auto subscription : subscriptions_)
+    {
+        network_->getEvents().unsubscribe(subscription);
+    }
+    subscriptions_.clear();
+    network_ = nullptr;
+}
+
+void ChatLog::push(EChatChannel channel, std::string_view sender, std::string_view text)
+{
+    text = text.substr(0, MAX_MESSAGE_LENGTH);
+
+    // Empty text takes no arena bytes, eviction couldn't tell when newer texts overwrite its neighbours
+    if(text.empty()) return;
+
+    // Text is always contiguous, wrap to arena start if it doesn't fit at the end. In that case the gap left at the
+    // end is consumed too, so messages living there are evicted as well.
+    size_t offset = arenaHead_;
+    size_t gap    = 0;
+    if(offset + text.size() > arenaSize_)
+    {
+        gap    = arenaSize_ - offset;
+        offset = 0;
+    }
+
+    auto overlaps = [](const Message& message, size_t begin, size_t end){
+        return message.textOffset < end && begin < message.textOffset + size_t(message.textLength);
+    };
+
+    // Evict messages whose text is going to be overwritten, and the oldest one if the ring is full
+    while(count_ > 0)
+    {
+        const auto& oldest = messages_[first_];
+        const bool bOverwritten = overlaps(oldest, offset, offset + text.size())
+                               || (gap > 0 && overlaps(oldest, arenaHead_, arenaSize_));
+
+        if(!bOverwritten && count_ < messages_.size()) break;
+        popOldest();
+    }
+
+    std::memcpy(arena_.get() + offset, text.data(), text.size());
+    arenaHead_ = offset + text.size();
+
+    auto& message = messages_[(first_ + count_) % messages_.size()];
+    message.sequence   = nextSequence_++;
+    message.textOffset = static_cast<uint32_t>(offset);
+    message.textLength = static_cast<uint16_t>(text.size());
+    message.sender     = internSender(sender);
+    message.channel    = channel;
+    ++count_;
+}
+
+void ChatLog::clear()
+{
+    while(count_ > 0)
+    {
+        popOldest();
+    }
+    arenaHead_ = 0;
+}
+
+ChatLog::Line ChatLog::getLine(size_t age) const
+{
+    assert(age < count_ && "ChatLog::getLine out of range");
+
+    const auto& message = messages_[(first_ + count_ - 1 - age) % messages_.size()];
+    const auto& sender  = senders_[message.sender];
+
+    return {
+        message.sequence,
+        message.channel,
+        { sender.name.data(), sender.length },
+        { arena_.get() + message.textOffset, message.textLength }
+    };
+}
+
+void ChatLog::popOldest()
+{
+    releaseSender(messages_[first_].sender);
+    first_ = (first_ + 1) % messages_.size();
+    --count_;
+}
+
+uint8_t ChatLog::internSender(std::string_view name)
+{
+    if(name.empty()) return NO_SENDER;
+
+    name = name.substr(0, MAX_SENDER_LENGTH);
+    const uint32_t hash = hashName(name);
+
+    size_t freeSlot = NO_SENDER;
+    for(size_t i = 1; i < senders_.size(); i++)
+    {
+        auto& sender = senders_[i];
+        if(sender.references > 0 && sender.hash == hash && std::string_view(sender.name.data(), sender.length) == name)
+        {
+            ++sender.references;
+            return static_cast<uint8_t>(i);
+        }
+
+        if(sender.references == 0 && freeSlot == NO_SENDER)
+        {
+            freeSlot = i;
+        }
+    }
+
+    // More distinct senders alive than MAX_SENDERS, messages of this one are shown without name
+    if(freeSlot == NO_SENDER) return NO_SENDER;
+
+    auto& sender = senders_[freeSlot];
+    sender.hash       = hash;
+    sender.references = 1;
+    sender.length     = static_cast<uint8_t>(name.size());
+    std::copy_n(name.data(), name.size(), sender.name.data());
+
+    return static_cast<uint8_t>(freeSlot);
+}
+
+void ChatLog::releaseSender(uint8_t sender)
+{
+    if(sender != NO_SENDER)
+    {
+        --senders_[sender].references;
+    }
+}
+
+void ChatLog::onGlobalMessage(const NetworkEvent::GlobalMessage& event)
+{
+    push(EChatChannel::Global, {}, event.message);
+}
+
+void ChatLog::onRoomMessage(const NetworkEvent::RoomMessage& event)
+{
+    push(EChatChannel::Room, {}, event.message);
+}
+
+void ChatLog::onPlayerMessage(const NetworkEvent::PlayerMessage& event)
+{
+    const auto& players = network_->getPlayers();
+    push(EChatChannel::Player, players.isValid(event.player) ? players.getPlayer(event.player).getName() : std::string_view{}, event.message);
+}
+
+void ChatLog::onPrivateMessage(const NetworkEvent::PrivateMessage& event)
+{
+    const auto& players = network_->getPlayers();
+    push(EChatChannel::Private, players.isValid(event.player) ? players.getPlayer(event.player).getName() : std::string_view{}, event.message);
+}
@@ -0,0 +1,155 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include <Configuration.hpp>
+#include <network/NetworkEvents.hpp>
+
+namespace lpm
+{
+    class INetwork;
+
+    enum class EChatChannel : uint8_t
+    {
+        Global,
+        Room,
+        Player,
+        Private
+    };
+
+    /**
+     * @brief Bounded history of chat messages.
+     *
+     * Memory is reserved once and never grows, no matter how long the session is:
+     * - Messages live in a fixed capacity ring, the oldest one is overwritten when full.
+     * - Text of every message is stored in a single byte ring (arena). Writing a message that overlaps the text of
+     *   the oldest messages evicts them.
+     * - Sender names are interned in a fixed table, messages only store a small id. Names not referenced by any
+     *   message are recycled.
+     *
+     * Every message gets an increasing sequence number that views can use to cache its layout.
+     */
+    class ChatLog
+    {
+    public:
+        static constexpr size_t DEFAULT_CAPACITY   = 512;
+        static constexpr size_t DEFAULT_ARENA_SIZE = 64 * 1024;
+        static constexpr size_t MAX_SENDERS        = 256;
+        static constexpr size_t MAX_SENDER_LENGTH  = 31;
+        static constexpr size_t MAX_MESSAGE_LENGTH = Configuration::MAX_CHAT_MESSAGE_LENGTH;
+
+        struct Line
+        {
+            uint64_t sequence;
+            EChatChannel channel;
+            std::string_view sender;
+            std::string_view text;
+        };
+
+    public:
+        explicit ChatLog(size_t capacity = DEFAULT_CAPACITY, size_t arenaSize = DEFAULT_ARENA_SIZE);
+        ~ChatLog();
+
+        ChatLog(const ChatLog&) = delete;
+        ChatLog& operator=(const ChatLog&) = delete;
+
+    public:
+        /**
+         * Store chat events of network until stopListening is called
+         */
+        void listen(INetwork& network);
+        void stopListening();
+
+        /**
+         * Add message. Text longer than MAX_MESSAGE_LENGTH is truncated, empty text is ignored.
+         */
+        void push(EChatChannel channel, std::string_view sender, std::string_view text);
+
+        void clear();
+
+    public:
+        /**
+         * Get number of stored messages
+         */
+        [[nodiscard]] size_t size() const { return count_; }
+
+        /**
+         * Get message by age
+         * @param age 0 is the newest message, size() - 1 the oldest one
+         */
+        [[nodiscard]] Line getLine(size_t age) const;
+
+        /**
+         * Get sequence the next pushed message will have. Changes every time a message is pushed.
+         */
+        [[nodiscard]] uint64_t getNextSequence() const { return nextSequence_; }
+
+    private:
+        struct Message
+        {
+            uint64_t sequence;
+            uint32_t textOffset;
+            uint16_t textLength;
+            uint8_t sender;
+            EChatChannel channel;
+        };
+
+        struct Sender
+        {
+            uint32_t hash;
+            uint32_t references;
+            uint8_t length;
+            std::array<char, MAX_SENDER_LENGTH + 1> name;
+        };
+
+    private:
+        void popOldest();
+        uint8_t internSender(std::string_view name);
+        void releaseSender(uint8_t sender);
+
+        void onGlobalMessage(const NetworkEvent::GlobalMessage& event);
+        void onRoomMessage(const NetworkEvent::RoomMessage& event);
+        void onPlayerMessage(const NetworkEvent::PlayerMessage& event);
+        void onPrivateMessage(const NetworkEvent::PrivateMessage& event);
+
+    private:
+        std::vector<Message> messages_;     //< Ring of messages
+        size_t first_ = 0;                  //< Index of oldest message
+        size_t count_ = 0;
+
+        std::unique_ptr<char[]> arena_;     //< Ring of message texts
+        const size_t arenaSize_;
+        size_t arenaHead_ = 0;              //< Next write position in arena
+
+        std::vector<Sender> senders_;
+        uint64_t nextSequence_ = 0;
+
+        INetwork* network_ = nullptr;
+        std::vector<NetworkEventBus::Subscription> subscriptions_;
+    };
+}
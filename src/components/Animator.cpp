@@ -66,6 +66,24 @@ sf::IntRect Animator::getCurrentRect(std::string_view animation) const
     return {};
 }
 
+sf::IntRect Animator::getRect(size_t animation, float time) const
+{
+    if(animation >= animations_.size() || animations_[animation].frames.empty())
+    {
+        return {};
+    }
+
+    const auto& anim = animations_[animation];
+    return anim.frames[static_cast<size_t>(std::fmod((time / anim.rate), anim.frames.size()))];
+}
+
+size_t Animator::findAnimation(std::string_view animation) const
+{
+    return static_cast<size_t>(std::distance(animations_.begin(), std::find_if(animations_.begin(), animations_.end(), [&](auto& anim){
+        return anim.name == animation;
+    })));
+}
+
 const std::vector<Animator::Animation>& Animator::getAnimations() const
 {
     return animations_;
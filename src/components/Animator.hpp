@@ -43,6 +43,19 @@ namespace lpm
 
         sf::IntRect getCurrentRect(std::string_view animation) const;
 
+        /**
+         * Get frame of animation at given time, without string lookups
+         * @param animation Index in getAnimations()
+         * @param time Seconds since animation started
+         */
+        sf::IntRect getRect(size_t animation, float time) const;
+
+        /**
+         * Find index of animation by name
+         * @return Index in getAnimations(), or getAnimations().size() if not found
+         */
+        size_t findAnimation(std::string_view animation) const;
+
 
         const std::vector<Animation>& getAnimations() const;
 
@@ -40,6 +40,12 @@ sf::View AspectRatio::getViewportAspectRatio(const sf::Vector2u& textureSize, co
     return view;
 }
 
+sf::Vector2f AspectRatio::getViewportSize(const sf::Vector2u& textureSize, const sf::Vector2u& targetSize, EAspectRatioRule rule)
+{
+    QuadSize quadSize = getQuadSize(textureSize, targetSize, rule);
+    return { quadSize.texWidth, quadSize.texHeight };
+}
+
 std::optional<sf::Vector2i> AspectRatio::transformPointToTextureCoords(const sf::Vector2u& textureSize, const sf::Vector2u& targetSize, EAspectRatioRule rule, sf::Vector2i point)
 {
     sf::Vector2i transform;
@@ -40,6 +40,11 @@ namespace lpm
 
         static sf::View getViewportAspectRatio(const sf::Vector2u& textureSize, const sf::Vector2u& targetSize, EAspectRatioRule rule);
 
+        /**
+         * Get size in target pixels of the quad the texture is drawn in
+         */
+        [[nodiscard]] static sf::Vector2f getViewportSize(const sf::Vector2u& textureSize, const sf::Vector2u& targetSize, EAspectRatioRule rule);
+
         [[nodiscard]] static std::optional<sf::Vector2i> transformPointToTextureCoords(const sf::Vector2u& textureSize, const sf::Vector2u& targetSize, EAspectRatioRule rule, sf::Vector2i point);
 
     private:
@@ -0,0 +1,70 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "AssetTiers.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <nlohmann/json.hpp>
+
+using namespace lpm;
+
+AssetTiers::AssetTiers(std::string_view manifest)
+{
+    std::ifstream file(manifest.data());
+    if(!file) throw asset_tiers_exception();
+
+    try
+    {
+        for(const auto& asset : nlohmann::json::parse(file))
+        {
+            std::vector<Variant> variants;
+            for(const auto& tier : asset.at("tiers"))
+            {
+                const float scale = tier.at("scale");
+                if(scale > 1.f) variants.push_back({ tier.at("file"), scale });
+            }
+
+            std::ranges::sort(variants, {}, &Variant::scale);
+            variants_.insert_or_assign(asset.at("name"), std::move(variants));
+        }
+    }
+    catch(const nlohmann::json::exception&)
+    {
+        throw asset_tiers_exception();
+    }
+}
+
+AssetTiers::Tier AssetTiers::select(std::string_view name, float viewportScale) const
+{
+    Tier tier{ name, 1.f };
+
+    const auto found = variants_.find(std::string(name));
+    if(found == variants_.end()) return tier;
+
+    for(const auto& variant : found->second)
+    {
+        if(tier.scale * MAX_UPSCALE >= viewportScale) break;
+        tier = { variant.file, variant.scale };
+    }
+
+    return tier;
+}
@@ -0,0 +1,83 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <exception>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace lpm
+{
+    class asset_tiers_exception final : public std::exception { };
+
+    /**
+     * @brief Resolution variants of assets, read from a manifest.
+     *
+     * Scenes are drawn in Configuration::BACKGROUND_TEX_SIZE units and stretched to the window. Some images also ship
+     * bigger variants ("loginScreen4x.png" for "loginScreen.png"), that only pay off when the window is big enough to
+     * show their pixels. The manifest lists them by base name:
+     *
+     *  [ { "name": "loginScreen.png", "tiers": [ { "file": "loginScreen4x.png", "scale": 4 } ] } ]
+     *
+     * Scale is pixels of the variant per scene unit. The base file is always tier 1 and assets without entry only
+     * have it.
+     */
+    class AssetTiers
+    {
+    public:
+        static constexpr float MAX_UPSCALE = 1.25f;    //< Stretch accepted before moving to a bigger tier
+
+        struct Tier
+        {
+            std::string_view file;
+            float scale = 1.f;
+        };
+
+    public:
+        AssetTiers() = default;
+
+        /**
+         * Read manifest
+         * @throw asset_tiers_exception if manifest can't be read
+         */
+        explicit AssetTiers(std::string_view manifest);
+
+    public:
+        /**
+         * Get smallest tier of asset that looks sharp at viewport scale, or the biggest one if none does
+         * @param name Base file name, returned as is if it has no tiers
+         * @param viewportScale Window pixels per scene unit
+         */
+        [[nodiscard]] Tier select(std::string_view name, float viewportScale) const;
+
+    private:
+        struct Variant
+        {
+            std::string file;
+            float scale;
+        };
+
+        std::unordered_map<std::string, std::vector<Variant>> variants_;    //< By base name, smallest scale first
+    };
+}
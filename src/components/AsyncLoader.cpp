@@ -0,0 +1,132 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "AsyncLoader.hpp"
+#include "TextureCache.hpp"
+
+#include <algorithm>
+
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Audio/SoundBuffer.hpp>
+
+using namespace lpm;
+
+AsyncLoader::Result::Result() = default;
+AsyncLoader::Result::Result(Result&&) noexcept = default;
+AsyncLoader::Result& AsyncLoader::Result::operator=(Result&&) noexcept = default;
+AsyncLoader::Result::~Result() = default;
+
+AsyncLoader::AsyncLoader()
+: worker_(&AsyncLoader::work, this)
+{
+
+}
+
+AsyncLoader::~AsyncLoader()
+{
+    {
+        std::scoped_lock lock(mutex_);
+        bStop_ = true;
+    }
+    wakeUp_.notify_one();
+    worker_.join();
+}
+
+uint32_t AsyncLoader::createBatch()
+{
+    std::scoped_lock lock(mutex_);
+    return ++lastBatch_;
+}
+
+void AsyncLoader::load(std::string_view fileName, EAssetType type, uint32_t batch)
+{
+    {
+        std::scoped_lock lock(mutex_);
+        requests_.push_back({ std::string(fileName), type, batch });
+    }
+    wakeUp_.notify_one();
+}
+
+void AsyncLoader::cancel(uint32_t batch)
+{
+    std::scoped_lock lock(mutex_);
+    std::erase_if(requests_, [&](const Request& request){ return request.batch == batch; });
+    std::erase_if(results_, [&](const Result& result){ return result.batch == batch; });
+    if(runningBatch_ == batch) bDiscardRunning_ = true;
+}
+
+size_t AsyncLoader::collect(uint32_t batch, std::vector<Result>& results)
+{
+    std::scoped_lock lock(mutex_);
+
+    const auto finished = std::stable_partition(results_.begin(), results_.end(), [&](const Result& result){ return result.batch != batch; });
+    const auto count = static_cast<size_t>(std::distance(finished, results_.end()));
+
+    std::move(finished, results_.end(), std::back_inserter(results));
+    results_.erase(finished, results_.end());
+    return count;
+}
+
+size_t AsyncLoader::getPendingCount() const
+{
+    std::scoped_lock lock(mutex_);
+    return requests_.size() + (runningBatch_ != 0 ? 1 : 0);
+}
+
+void AsyncLoader::work()
+{
+    while(true)
+    {
+        Request request;
+        {
+            std::unique_lock lock(mutex_);
+            wakeUp_.wait(lock, [this]{ return bStop_ || !requests_.empty(); });
+            if(bStop_) return;
+
+            request = std::move(requests_.front());
+            requests_.pop_front();
+            runningBatch_ = request.batch;
+            bDiscardRunning_ = false;
+        }
+
+        Result result;
+        result.fileName = std::move(request.fileName);
+        result.type = request.type;
+        result.batch = request.batch;
+
+        switch(request.type)
+        {
+            case EAssetType::Image:
+                result.image = std::make_unique<sf::Image>();
+                result.bLoaded = TextureCache::loadImage(result.fileName, *result.image);
+                break;
+
+            case EAssetType::Sound:
+                result.sound = std::make_unique<sf::SoundBuffer>();
+                result.bLoaded = result.sound->loadFromFile(result.fileName);
+                break;
+        }
+
+        std::scoped_lock lock(mutex_);
+        if(!bDiscardRunning_) results_.push_back(std::move(result));
+        runningBatch_ = 0;
+    }
+}
@@ -0,0 +1,132 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace sf
+{
+    class Image;
+    class SoundBuffer;
+}
+
+namespace lpm
+{
+    enum class EAssetType : uint8_t
+    {
+        Image,
+        Sound
+    };
+
+    /**
+     * @brief Decodes assets in a worker thread.
+     *
+     * Files are read and decoded into sf::Image or sf::SoundBuffer away from the main thread. Images still have to be
+     * uploaded into a sf::Texture by the thread owning the GL context, usually right after collect().
+     *
+     * Requests are grouped in batches, so a whole group can be collected or cancelled at once.
+     */
+    class AsyncLoader
+    {
+    public:
+        struct Result
+        {
+            std::string fileName;
+            EAssetType type = EAssetType::Image;
+            uint32_t batch  = 0;
+            bool bLoaded    = false;                //< False if file couldn't be read or decoded
+
+            std::unique_ptr<sf::Image> image;       //< Set for loaded EAssetType::Image
+            std::unique_ptr<sf::SoundBuffer> sound; //< Set for loaded EAssetType::Sound
+
+            Result();
+            Result(Result&&) noexcept;
+            Result& operator=(Result&&) noexcept;
+            ~Result();
+        };
+
+    public:
+        AsyncLoader();
+        ~AsyncLoader();
+
+        AsyncLoader(const AsyncLoader&) = delete;
+        AsyncLoader& operator=(const AsyncLoader&) = delete;
+
+    public:
+        /**
+         * Get id for a new group of requests
+         */
+        [[nodiscard]] uint32_t createBatch();
+
+        /**
+         * Queue file to be decoded
+         */
+        void load(std::string_view fileName, EAssetType type, uint32_t batch);
+
+        /**
+         * Forget batch. Queued requests are removed and results, finished or not, are discarded.
+         */
+        void cancel(uint32_t batch);
+
+        /**
+         * Move finished results of batch into results
+         * @return Number of results moved
+         */
+        size_t collect(uint32_t batch, std::vector<Result>& results);
+
+        /**
+         * Get number of requests queued or being decoded
+         */
+        [[nodiscard]] size_t getPendingCount() const;
+
+    private:
+        struct Request
+        {
+            std::string fileName;
+            EAssetType type = EAssetType::Image;
+            uint32_t batch  = 0;
+        };
+
+        void work();
+
+    private:
+        mutable std::mutex mutex_;
+        std::condition_variable wakeUp_;
+
+        std::deque<Request> requests_;
+        std::vector<Result> results_;
+        uint32_t runningBatch_ = 0;             //< Batch of request being decoded, 0 if idle
+        uint32_t lastBatch_ = 0;
+        bool bDiscardRunning_ = false;          //< Running request was cancelled
+        bool bStop_ = false;
+
+        std::thread worker_;                    //< Last member, so it starts after everything else is ready
+    };
+}
@@ -0,0 +1,93 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace lpm
+{
+    template<typename Signature, size_t StorageSize = 2 * sizeof(void*)>
+    class Delegate;
+
+    /**
+     * @brief Small callable wrapper that never allocates.
+     *
+     * Unlike std::function, the callable is stored inline inside the delegate, so it must be trivially copyable
+     * and fit into StorageSize bytes. That covers plain functions, member functions bound with Delegate::bind and
+     * lambdas capturing a couple of pointers, which is all the event handlers need.
+     *
+     * @example:
+     * Delegate<void(int)> a = [this](int value){ counter_ += value; };
+     * auto b = Delegate<void(int)>::bind<&Foo::onValue>(&foo);
+     */
+    template<typename Return, typename... Args, size_t StorageSize>
+    class Delegate<Return(Args...), StorageSize>
+    {
+        using Invoker = Return(*)(void*, Args...);
+
+    public:
+        Delegate() = default;
+
+        template<typename Callable>
+        requires (!std::is_same_v<std::decay_t<Callable>, Delegate>) && std::is_invocable_r_v<Return, Callable&, Args...>
+        Delegate(Callable callable)
+        {
+            static_assert(sizeof(Callable) <= StorageSize, "Delegate callable is bigger than its inline storage");
+            static_assert(alignof(Callable) <= alignof(void*), "Delegate callable is over-aligned");
+            static_assert(std::is_trivially_copyable_v<Callable> && std::is_trivially_destructible_v<Callable>
+            , "Delegate only accepts trivially copyable callables (capture pointers, not owning objects)");
+
+            ::new(static_cast<void*>(storage_)) Callable(callable);
+            invoker_ = [](void* storage, Args... args) -> Return {
+                return (*std::launder(static_cast<Callable*>(storage)))(std::forward<Args>(args)...);
+            };
+        }
+
+        /**
+         * Create a delegate that calls Method over instance
+         * @return Delegate bound to instance
+         */
+        template<auto Method, typename Class>
+        [[nodiscard]] static Delegate bind(Class* instance)
+        {
+            return Delegate([instance](Args... args) -> Return {
+                return (instance->*Method)(std::forward<Args>(args)...);
+            });
+        }
+
+        Return operator()(Args... args) const
+        {
+            assert(invoker_ != nullptr && "Calling an empty Delegate");
+            return invoker_(storage_, std::forward<Args>(args)...);
+        }
+
+        explicit operator bool() const { return invoker_ != nullptr; }
+
+    private:
+        alignas(void*) mutable std::byte storage_[StorageSize] {};
+        Invoker invoker_ = nullptr;
+    };
+}
@@ -0,0 +1,482 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <components/Delegate.hpp>
+
+namespace lpm
+{
+    /**
+     * @brief Typed multicast event queue.
+     *
+     * Events are small trivially copyable structs that describe their members through a static `fields()` function
+     * returning a tuple of member pointers. Publishing copies the event, and every std::string_view or std::span
+     * member found in `fields()`, into a fixed size buffer. The bus is double buffered: events published during the
+     * frame are delivered together when dispatch() is called, and events published while dispatching are kept for
+     * the next frame.
+     *
+     * Nothing is allocated after construction. When a buffer is full the event is dropped and counted.
+     *
+     * @example:
+     * struct Message
+     * {
+     *     std::string_view text;
+     *     static constexpr auto fields() { return std::tuple{&Message::text}; }
+     * };
+     *
+     * EventBus<Message> bus;
+     * bus.subscribe<Message>([](const Message& message){ std::cout << message.text; });
+     * bus.publish(Message{"hello"});
+     * bus.dispatch();
+     */
+    template<typename... Events>
+    class EventBus
+    {
+        static constexpr size_t RECORD_ALIGN = alignof(std::max_align_t);
+
+        static_assert(sizeof...(Events) > 0, "EventBus needs at least one event type");
+        static_assert((std::is_trivially_copyable_v<Events> && ...), "EventBus events must be trivially copyable");
+        static_assert((std::is_default_constructible_v<Events> && ...), "EventBus events must be default constructible");
+        static_assert(((alignof(Events) <= RECORD_ALIGN) && ...), "EventBus events can't be over-aligned");
+
+    public:
+        static constexpr uint32_t INVALID_TYPE = std::numeric_limits<uint32_t>::max();
+        static constexpr size_t DEFAULT_RECORD_CAPACITY  = 64 * 1024;
+        static constexpr size_t DEFAULT_PAYLOAD_CAPACITY = 256 * 1024;
+
+        template<typename Event>
+        using Handler = Delegate<void(const Event&)>;
+
+        /**
+         * Called on every publish with the type index and a pointer to the event, before it's queued
+         */
+        using PublishHook = Delegate<void(uint32_t, const void*)>;
+
+        struct Subscription
+        {
+            uint32_t type = INVALID_TYPE;
+            uint32_t id   = 0;
+        };
+
+        /**
+         * Counters of one event type since the bus was created
+         */
+        struct TypeStats
+        {
+            uint64_t published = 0;             //< Events queued
+            uint64_t dropped   = 0;             //< Events lost because a buffer was full
+            uint64_t bytes     = 0;             //< Bytes of queued records and their payload
+            uint64_t dispatchNanoseconds = 0;   //< Time spent in handlers, only while profiling
+            uint64_t decoded   = 0;             //< Events published with the time taken to decode them
+            uint64_t decodeNanoseconds = 0;     //< Decode time reported by publishers
+        };
+
+        /**
+         * Index of Event inside the bus. It's stable as long as the event list keeps its order.
+         */
+        template<typename Event>
+        static constexpr uint32_t typeIndex()
+        {
+            constexpr bool matches[] = { std::is_same_v<Event, Events>... };
+            for(uint32_t i = 0; i < sizeof...(Events); i++)
+            {
+                if(matches[i]) return i;
+            }
+            return INVALID_TYPE;
+        }
+
+        static constexpr uint32_t typeCount() { return sizeof...(Events); }
+
+        /**
+         * Call function with event casted to its real type
+         * @param type Type index of event
+         * @param event Pointer to an event of type
+         */
+        template<typename Function>
+        static void visit(uint32_t type, const void* event, Function&& function)
+        {
+            (void)((type == typeIndex<Events>() ? (function(*static_cast<const Events*>(event)), true) : false) || ...);
+        }
+
+        /**
+         * Call function with std::type_identity of the event type
+         * @param type Type index of event
+         * @return False if type isn't part of this bus
+         */
+        template<typename Function>
+        static bool visitType(uint32_t type, Function&& function)
+        {
+            return ((type == typeIndex<Events>() ? (function(std::type_identity<Events>{}), true) : false) || ...);
+        }
+
+    public:
+        explicit EventBus(size_t recordCapacity = DEFAULT_RECORD_CAPACITY, size_t payloadCapacity = DEFAULT_PAYLOAD_CAPACITY)
+        : recordCapacity_(recordCapacity)
+        , payloadCapacity_(payloadCapacity)
+        {
+            for(auto& buffer : buffers_)
+            {
+                buffer.records = std::make_unique<std::byte[]>(recordCapacity_);
+                buffer.payload = std::make_unique<std::byte[]>(payloadCapacity_);
+            }
+        }
+
+        EventBus(const EventBus&) = delete;
+        EventBus& operator=(const EventBus&) = delete;
+
+    public:
+        /**
+         * Register handler to be called for every dispatched Event.
+         * @return Subscription used to unsubscribe
+         */
+        template<typename Event>
+        Subscription subscribe(Handler<Event> handler)
+        {
+            constexpr uint32_t type = typeIndex<Event>();
+            static_assert(type != INVALID_TYPE, "Event isn't part of this EventBus");
+
+            const uint32_t id = ++lastSubscriptionId_;
+            std::get<Subscribers<Event>>(subscribers_).push_back({id, handler});
+            return {type, id};
+        }
+
+        /**
+         * Remove a previous subscription. It's safe to call it from inside a handler.
+         */
+        void unsubscribe(Subscription subscription)
+        {
+            if(subscription.type == INVALID_TYPE) return;
+
+            forEachSubscribers([&](auto& subscribers, uint32_t type){
+                if(type != subscription.type) return;
+                for(auto& subscriber : subscribers)
+                {
+                    if(subscriber.id == subscription.id)
+                    {
+                        subscriber = {};
+                        bPendingCompact_ = true;
+                    }
+                }
+            });
+        }
+
+        /**
+         * Queue event to be delivered on next dispatch. Thread safe.
+         * @param decodeTime Time the publisher took to decode the event from the wire, if it did
+         * @return False if the event was dropped because the frame buffer is full
+         */
+        template<typename Event>
+        bool publish(Event event, std::chrono::nanoseconds decodeTime = {})
+        {
+            constexpr uint32_t type = typeIndex<Event>();
+            static_assert(type != INVALID_TYPE, "Event isn't part of this EventBus");
+
+            constexpr size_t headerSize = align(sizeof(RecordHeader), RECORD_ALIGN);
+            constexpr size_t recordSize = headerSize + align(sizeof(Event), RECORD_ALIGN);
+
+            std::scoped_lock lock(mutex_);
+            if(decodeTime.count() > 0)
+            {
+                ++stats_[type].decoded;
+                stats_[type].decodeNanoseconds += static_cast<uint64_t>(decodeTime.count());
+            }
+
+            Buffer& back = buffers_[backIndex_];
+
+            const size_t payloadUsed = back.payloadUsed;
+            if(back.recordsUsed + recordSize > recordCapacity_ || !relocatePayload(back, event))
+            {
+                back.payloadUsed = payloadUsed;
+                ++droppedCount_;
+                ++stats_[type].dropped;
+                return false;
+            }
+
+            ++stats_[type].published;
+            stats_[type].bytes += recordSize + back.payloadUsed - payloadUsed;
+
+            std::byte* record = back.records.get() + back.recordsUsed;
+            const RecordHeader header { type, static_cast<uint32_t>(recordSize) };
+            std::memcpy(record, &header, sizeof(RecordHeader));
+            std::memcpy(record + headerSize, &event, sizeof(Event));
+
+            back.recordsUsed += recordSize;
+            ++back.count;
+
+            if(publishHook_)
+            {
+                publishHook_(type, &event);
+            }
+            return true;
+        }
+
+        /**
+         * Deliver every event published since last dispatch, in publish order.
+         */
+        void dispatch()
+        {
+            Buffer* front = nullptr;
+            {
+                std::scoped_lock lock(mutex_);
+                front = &buffers_[backIndex_];
+                backIndex_ = 1 - backIndex_;
+            }
+
+            constexpr size_t headerSize = align(sizeof(RecordHeader), RECORD_ALIGN);
+            for(size_t offset = 0; offset < front->recordsUsed;)
+            {
+                RecordHeader header {};
+                std::memcpy(&header, front->records.get() + offset, sizeof(RecordHeader));
+
+                if(bProfiling_)
+                {
+                    const auto start = std::chrono::steady_clock::now();
+                    DISPATCHERS[header.type](*this, front->records.get() + offset + headerSize);
+                    const auto elapsed = std::chrono::steady_clock::now() - start;
+                    dispatchNanoseconds_[header.type] += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+                }
+                else
+                {
+                    DISPATCHERS[header.type](*this, front->records.get() + offset + headerSize);
+                }
+                offset += header.size;
+            }
+
+            lastDispatchCount_ = front->count;
+            front->recordsUsed = 0;
+            front->payloadUsed = 0;
+            front->count       = 0;
+
+            if(bPendingCompact_)
+            {
+                compact();
+            }
+        }
+
+        /**
+         * Set function observing every event accepted by the bus, dropped ones aren't seen. Hook is called while
+         * the bus is locked, so it can't publish and should return quickly.
+         */
+        void setPublishHook(PublishHook hook)
+        {
+            std::scoped_lock lock(mutex_);
+            publishHook_ = hook;
+        }
+
+        /**
+         * Measure time spent by handlers of each event type. Costs two clock reads per dispatched event.
+         */
+        void setProfiling(bool bProfiling) { bProfiling_ = bProfiling; }
+        [[nodiscard]] bool isProfiling() const { return bProfiling_; }
+
+    public:
+        /**
+         * Get number of events waiting to be dispatched
+         */
+        [[nodiscard]] size_t getPendingCount() const
+        {
+            std::scoped_lock lock(mutex_);
+            return buffers_[backIndex_].count;
+        }
+
+        /**
+         * Get number of events delivered by the last dispatch
+         */
+        [[nodiscard]] size_t getLastDispatchCount() const { return lastDispatchCount_; }
+
+        /**
+         * Get number of events dropped since the bus was created because a buffer was full
+         */
+        [[nodiscard]] size_t getDroppedCount() const
+        {
+            std::scoped_lock lock(mutex_);
+            return droppedCount_;
+        }
+
+        /**
+         * Get counters of an event type
+         * @param type Type index of event
+         */
+        [[nodiscard]] TypeStats getStats(uint32_t type) const
+        {
+            if(type >= sizeof...(Events)) return {};
+
+            std::scoped_lock lock(mutex_);
+            TypeStats stats = stats_[type];
+            stats.dispatchNanoseconds = dispatchNanoseconds_[type];
+            return stats;
+        }
+
+    private:
+        struct RecordHeader
+        {
+            uint32_t type;
+            uint32_t size;
+        };
+
+        struct Buffer
+        {
+            std::unique_ptr<std::byte[]> records;
+            std::unique_ptr<std::byte[]> payload;
+            size_t recordsUsed = 0;
+            size_t payloadUsed = 0;
+            size_t count       = 0;
+        };
+
+        template<typename Event>
+        struct Subscriber
+        {
+            uint32_t id = 0;
+            Handler<Event> handler;
+        };
+
+        template<typename Event>
+        using Subscribers = std::vector<Subscriber<Event>>;
+
+        template<typename Type>
+        struct IsSpan : std::false_type {};
+
+        template<typename Type, size_t Extent>
+        struct IsSpan<std::span<Type, Extent>> : std::true_type {};
+
+        using Dispatcher = void(*)(EventBus&, const std::byte*);
+
+    private:
+        static constexpr size_t align(size_t value, size_t alignment)
+        {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+
+        static std::byte* allocate(Buffer& buffer, size_t capacity, size_t size, size_t alignment)
+        {
+            const size_t offset = align(buffer.payloadUsed, alignment);
+            if(offset + size > capacity) return nullptr;
+
+            buffer.payloadUsed = offset + size;
+            return buffer.payload.get() + offset;
+        }
+
+        template<typename Event>
+        bool relocatePayload(Buffer& buffer, Event& event)
+        {
+            return std::apply([&](auto... members){
+                return (relocateField(buffer, event.*members) && ...);
+            }, Event::fields());
+        }
+
+        template<typename Field>
+        bool relocateField(Buffer& buffer, Field& field)
+        {
+            if constexpr(std::is_same_v<Field, std::string_view>)
+            {
+                if(field.empty()) return true;
+
+                auto* data = allocate(buffer, payloadCapacity_, field.size(), 1);
+                if(!data) return false;
+
+                std::memcpy(data, field.data(), field.size());
+                field = std::string_view(reinterpret_cast<const char*>(data), field.size());
+            }
+            else if constexpr(IsSpan<Field>::value)
+            {
+                using Element = std::remove_cv_t<typename Field::element_type>;
+                static_assert(std::is_trivially_copyable_v<Element>, "EventBus span elements must be trivially copyable");
+
+                if(field.empty()) return true;
+
+                auto* data = allocate(buffer, payloadCapacity_, field.size_bytes(), alignof(Element));
+                if(!data) return false;
+
+                std::memcpy(data, field.data(), field.size_bytes());
+                field = Field(reinterpret_cast<Element*>(data), field.size());
+            }
+            return true;
+        }
+
+        template<typename Event>
+        static void dispatchRecord(EventBus& bus, const std::byte* data)
+        {
+            Event event;
+            std::memcpy(&event, data, sizeof(Event));
+
+            // Handlers can subscribe while dispatching, so don't hold references into the vector
+            auto& subscribers = std::get<Subscribers<Event>>(bus.subscribers_);
+            const size_t count = subscribers.size();
+            for(size_t i = 0; i < count; i++)
+            {
+                if(const auto handler = subscribers[i].handler)
+                {
+                    handler(event);
+                }
+            }
+        }
+
+        template<typename Function>
+        void forEachSubscribers(Function&& function)
+        {
+            [&]<size_t... Indices>(std::index_sequence<Indices...>){
+                (function(std::get<Indices>(subscribers_), static_cast<uint32_t>(Indices)), ...);
+            }(std::index_sequence_for<Events...>{});
+        }
+
+        void compact()
+        {
+            forEachSubscribers([](auto& subscribers, uint32_t){
+                std::erase_if(subscribers, [](const auto& subscriber){ return subscriber.id == 0; });
+            });
+            bPendingCompact_ = false;
+        }
+
+    private:
+        static constexpr Dispatcher DISPATCHERS[] = { &EventBus::dispatchRecord<Events>... };
+
+        const size_t recordCapacity_;
+        const size_t payloadCapacity_;
+
+        mutable std::mutex mutex_;
+        std::array<Buffer, 2> buffers_;
+        size_t backIndex_     = 0;
+        size_t droppedCount_  = 0;
+        PublishHook publishHook_;
+        std::array<TypeStats, sizeof...(Events)> stats_ {};                 //< Written while locked
+        std::array<uint64_t, sizeof...(Events)> dispatchNanoseconds_ {};    //< Written by dispatch thread
+
+        std::tuple<Subscribers<Events>...> subscribers_;
+        size_t lastDispatchCount_ = 0;
+        uint32_t lastSubscriptionId_ = 0;
+        bool bPendingCompact_ = false;
+        bool bProfiling_ = false;
+    };
+}
@@ -0,0 +1,169 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace lpm
+{
+    /**
+     * @brief Generational handle.
+     *
+     * Index points to a slot of a HandlePool, generation detects handles that outlived the object they pointed to.
+     * Tag only makes handles of different pools incompatible between them.
+     */
+    template<typename Tag>
+    struct Handle
+    {
+        static constexpr uint16_t INVALID_INDEX = std::numeric_limits<uint16_t>::max();
+
+        uint16_t index      = INVALID_INDEX;
+        uint16_t generation = 0;
+
+        [[nodiscard]] bool isValid() const { return index != INVALID_INDEX; }
+        [[nodiscard]] uint32_t pack() const { return uint32_t(generation) << 16 | index; }
+        [[nodiscard]] static Handle unpack(uint32_t value) { return { uint16_t(value & 0xFFFF), uint16_t(value >> 16) }; }
+
+        bool operator==(const Handle&) const = default;
+    };
+
+    /**
+     * @brief Fixed capacity allocator of generational handles.
+     *
+     * Every live handle owns a stable slot and a dense index. Dense indices are always packed in [0, size), so users
+     * can keep their per-object data in plain arrays indexed by dense index and iterate them without holes. Releasing
+     * a handle moves the last dense entry into the hole; release() reports the move so the user can mirror it.
+     *
+     * Every container is allocated in the constructor, acquire and release never allocate.
+     */
+    template<typename Tag>
+    class HandlePool
+    {
+    public:
+        using HandleType = Handle<Tag>;
+
+        struct Removal
+        {
+            uint16_t dense;  //< Dense index that was freed
+            uint16_t moved;  //< Dense index moved into `dense`, equal to `dense` if it was the last one
+        };
+
+    public:
+        explicit HandlePool(size_t capacity)
+        : generations_(capacity, 0)
+        , sparse_(capacity, HandleType::INVALID_INDEX)
+        , dense_(capacity, HandleType::INVALID_INDEX)
+        {
+            assert(capacity < HandleType::INVALID_INDEX && "HandlePool capacity exceeds handle index range");
+
+            freeList_.reserve(capacity);
+            for(size_t i = capacity; i > 0; i--)
+            {
+                freeList_.push_back(static_cast<uint16_t>(i - 1));
+            }
+        }
+
+    public:
+        /**
+         * Get a new handle
+         * @return Valid handle, or invalid handle if pool is full
+         */
+        [[nodiscard]] HandleType acquire()
+        {
+            if(freeList_.empty()) return {};
+
+            const uint16_t slot = freeList_.back();
+            freeList_.pop_back();
+
+            sparse_[slot] = static_cast<uint16_t>(size_);
+            dense_[size_] = slot;
+            ++size_;
+
+            return { slot, generations_[slot] };
+        }
+
+        /**
+         * Release handle. Its slot will be reused with a new generation.
+         * @return Dense movement that user must mirror on its own arrays
+         */
+        Removal release(HandleType handle)
+        {
+            assert(isAlive(handle) && "Releasing a dead handle");
+
+            const uint16_t dense = sparse_[handle.index];
+            const auto last = static_cast<uint16_t>(size_ - 1);
+
+            const uint16_t lastSlot = dense_[last];
+            dense_[dense]    = lastSlot;
+            sparse_[lastSlot] = dense;
+
+            sparse_[handle.index] = HandleType::INVALID_INDEX;
+            dense_[last] = HandleType::INVALID_INDEX;
+            ++generations_[handle.index];
+            freeList_.push_back(handle.index);
+            --size_;
+
+            return { dense, last };
+        }
+
+        [[nodiscard]] bool isAlive(HandleType handle) const
+        {
+            return handle.index < generations_.size()
+                && generations_[handle.index] == handle.generation
+                && sparse_[handle.index] != HandleType::INVALID_INDEX;
+        }
+
+        [[nodiscard]] uint16_t getDenseIndex(HandleType handle) const
+        {
+            assert(isAlive(handle) && "Dense index of a dead handle");
+            return sparse_[handle.index];
+        }
+
+        [[nodiscard]] HandleType getHandle(size_t dense) const
+        {
+            const uint16_t slot = dense_[dense];
+            return { slot, generations_[slot] };
+        }
+
+        [[nodiscard]] HandleType getSlotHandle(uint16_t slot) const
+        {
+            return { slot, generations_[slot] };
+        }
+
+        [[nodiscard]] std::span<const uint16_t> getDenseSlots() const { return { dense_.data(), size_ }; }
+
+        [[nodiscard]] size_t size() const { return size_; }
+        [[nodiscard]] size_t capacity() const { return generations_.size(); }
+        [[nodiscard]] bool full() const { return freeList_.empty(); }
+
+    private:
+        std::vector<uint16_t> generations_;     //< Per slot generation
+        std::vector<uint16_t> sparse_;          //< Slot to dense index
+        std::vector<uint16_t> dense_;           //< Dense index to slot
+        std::vector<uint16_t> freeList_;        //< Free slots
+        size_t size_ = 0;
+    };
+}
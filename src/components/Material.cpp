@@ -0,0 +1,185 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "Material.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+#include <SFML/Graphics/Shader.hpp>
+
+using namespace lpm;
+
+Material::Material(sf::Shader& shader)
+: shader_(shader)
+{
+}
+
+Material::Uniform Material::addFloat(std::string_view name, size_t count)
+{
+    const auto uniform = add(name, EType::Float, static_cast<uint32_t>(floats_.size()), count);
+    floats_.resize(floats_.size() + count, 0.f);
+    recordedFloats_.resize(floats_.size(), 0.f);
+    return uniform;
+}
+
+Material::Uniform Material::addVec3(std::string_view name, size_t count)
+{
+    const auto uniform = add(name, EType::Vec3, static_cast<uint32_t>(vectors_.size()), count);
+    vectors_.resize(vectors_.size() + count);
+    recordedVectors_.resize(vectors_.size());
+    return uniform;
+}
+
+Material::Uniform Material::addTexture(std::string_view name)
+{
+    const auto uniform = add(name, EType::Texture, static_cast<uint32_t>(textures_.size()), 1);
+    textures_.push_back(nullptr);
+    recordedTextures_.push_back(nullptr);
+
+    // Samplers without texture can't be uploaded
+    uniforms_[uniform].bDirty = false;
+    dirty_.pop_back();
+    return uniform;
+}
+
+void Material::setFloat(Uniform uniform, float value, size_t index)
+{
+    const auto& entry = uniforms_[uniform];
+    assert(entry.type == EType::Float && index < entry.count && "Material::setFloat called on wrong uniform");
+
+    auto& staged = floats_[entry.offset + index];
+    if(staged == value) return;
+
+    staged = value;
+    markDirty(uniform);
+}
+
+void Material::setVec3(Uniform uniform, const sf::Glsl::Vec3& value, size_t index)
+{
+    const auto& entry = uniforms_[uniform];
+    assert(entry.type == EType::Vec3 && index < entry.count && "Material::setVec3 called on wrong uniform");
+
+    auto& staged = vectors_[entry.offset + index];
+    if(staged == value) return;
+
+    staged = value;
+    markDirty(uniform);
+}
+
+void Material::setTexture(Uniform uniform, const sf::Texture& texture)
+{
+    const auto& entry = uniforms_[uniform];
+    assert(entry.type == EType::Texture && "Material::setTexture called on wrong uniform");
+
+    auto& staged = textures_[entry.offset];
+    if(staged == &texture) return;
+
+    staged = &texture;
+    markDirty(uniform);
+}
+
+void Material::record()
+{
+    for(const auto uniform : dirty_)
+    {
+        auto& entry = uniforms_[uniform];
+        entry.bDirty = false;
+
+        switch(entry.type)
+        {
+            case EType::Float:
+                std::copy_n(&floats_[entry.offset], entry.count, &recordedFloats_[entry.offset]);
+                break;
+
+            case EType::Vec3:
+                std::copy_n(&vectors_[entry.offset], entry.count, &recordedVectors_[entry.offset]);
+                break;
+
+            case EType::Texture:
+                recordedTextures_[entry.offset] = textures_[entry.offset];
+                break;
+        }
+
+        // Recorded again before being drawn, the newer copy is uploaded once
+        if(entry.bRecorded) continue;
+
+        entry.bRecorded = true;
+        recorded_.push_back(uniform);
+        uploads_++;
+    }
+
+    dirty_.clear();
+}
+
+void Material::apply()
+{
+    for(const auto uniform : recorded_)
+    {
+        auto& entry = uniforms_[uniform];
+        entry.bRecorded = false;
+
+        switch(entry.type)
+        {
+            case EType::Float:
+                if(entry.count == 1) shader_.setUniform(entry.name, recordedFloats_[entry.offset]);
+                else shader_.setUniformArray(entry.name, &recordedFloats_[entry.offset], entry.count);
+                break;
+
+            case EType::Vec3:
+                if(entry.count == 1) shader_.setUniform(entry.name, recordedVectors_[entry.offset]);
+                else shader_.setUniformArray(entry.name, &recordedVectors_[entry.offset], entry.count);
+                break;
+
+            case EType::Texture:
+                shader_.setUniform(entry.name, *recordedTextures_[entry.offset]);
+                break;
+        }
+    }
+
+    recorded_.clear();
+}
+
+float Material::getFloat(Uniform uniform, size_t index) const
+{
+    return floats_[uniforms_[uniform].offset + index];
+}
+
+Material::Uniform Material::add(std::string_view name, EType type, uint32_t offset, size_t count)
+{
+    assert(count > 0 && "Material uniform without elements");
+
+    const auto uniform = static_cast<Uniform>(uniforms_.size());
+    uniforms_.push_back({ std::string(name), type, offset, static_cast<uint32_t>(count), true, false });
+
+    // First apply sets every uniform, so the shader and the staged values agree
+    dirty_.push_back(uniform);
+    return uniform;
+}
+
+void Material::markDirty(Uniform uniform)
+{
+    auto& entry = uniforms_[uniform];
+    if(entry.bDirty) return;
+
+    entry.bDirty = true;
+    dirty_.push_back(uniform);
+}
@@ -0,0 +1,127 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <SFML/Graphics/Glsl.hpp>
+
+namespace sf
+{
+    class Shader;
+    class Texture;
+}
+
+namespace lpm
+{
+    /**
+     * @brief Uniform values of a shader, staged on CPU and uploaded when they change.
+     *
+     * Every sf::Shader::setUniform looks the uniform up by name and binds and unbinds the program. Material registers
+     * uniforms once and hands out handles; setters just write the staged value and mark it dirty if it changed.
+     * apply() uploads dirty uniforms only, arrays with a single call, so a uniform that keeps its value costs nothing
+     * and an array of N values costs one upload instead of N.
+     *
+     * Draws can run in a render thread while setters keep being called. record() copies the dirty values when the draw
+     * is recorded, and apply() uploads those copies, so a frame gets the values it was recorded with.
+     */
+    class Material
+    {
+    public:
+        using Uniform = uint16_t;
+
+    public:
+        explicit Material(sf::Shader& shader);
+
+    public:
+        /**
+         * Register uniform, values start at zero
+         * @param count Elements of an array uniform, 1 for a plain one
+         * @return Handle for setters
+         */
+        Uniform addFloat(std::string_view name, size_t count = 1);
+        Uniform addVec3(std::string_view name, size_t count = 1);
+        Uniform addTexture(std::string_view name);
+
+        void setFloat(Uniform uniform, float value, size_t index = 0);
+        void setVec3(Uniform uniform, const sf::Glsl::Vec3& value, size_t index = 0);
+        void setTexture(Uniform uniform, const sf::Texture& texture);
+
+        /**
+         * Copy changed uniforms for the next apply(). Call it when the draw is recorded.
+         */
+        void record();
+
+        /**
+         * Upload uniforms copied by record() into the shader. Call it once per draw, where the draw runs.
+         */
+        void apply();
+
+    public:
+        [[nodiscard]] float getFloat(Uniform uniform, size_t index = 0) const;
+
+        /**
+         * Uniform uploads recorded since creation
+         */
+        [[nodiscard]] size_t getUploadCount() const { return uploads_; }
+
+    private:
+        enum class EType : uint8_t
+        {
+            Float,
+            Vec3,
+            Texture
+        };
+
+        struct Entry
+        {
+            std::string name;
+            EType type;
+            uint32_t offset;                        //< First element in the storage of its type
+            uint32_t count;
+            bool bDirty;
+            bool bRecorded;                         //< Copied by record(), not uploaded yet
+        };
+
+        Uniform add(std::string_view name, EType type, uint32_t offset, size_t count);
+        void markDirty(Uniform uniform);
+
+    private:
+        sf::Shader& shader_;
+
+        std::vector<Entry> uniforms_;
+        std::vector<Uniform> dirty_;                //< Uniforms changed since last record
+        std::vector<float> floats_;
+        std::vector<sf::Glsl::Vec3> vectors_;
+        std::vector<const sf::Texture*> textures_;
+
+        // Copies read by apply(), laid out as the staged values
+        std::vector<Uniform> recorded_;             //< Uniforms to upload on next apply
+        std::vector<float> recordedFloats_;
+        std::vector<sf::Glsl::Vec3> recordedVectors_;
+        std::vector<const sf::Texture*> recordedTextures_;
+        size_t uploads_ = 0;
+    };
+}
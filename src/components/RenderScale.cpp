@@ -0,0 +1,147 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "RenderScale.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <SFML/Graphics/RenderTexture.hpp>
+#include <SFML/Graphics/RectangleShape.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/OpenGL.hpp>
+#include <SFML/System/Clock.hpp>
+
+#include <components/AspectRatio.hpp>
+#include <Configuration.hpp>
+
+using namespace lpm;
+
+namespace
+{
+    const sf::Vector2u SCENE_SIZE = { Configuration::BACKGROUND_TEX_SIZE_X, Configuration::BACKGROUND_TEX_SIZE_Y };
+
+    /**
+     * Get smallest multiple that shows every window pixel
+     */
+    unsigned getWindowScale(sf::Vector2u windowSize)
+    {
+        const auto viewport = AspectRatio::getViewportSize(SCENE_SIZE, windowSize, AspectRatio::EAspectRatioRule::FitToParent);
+        return static_cast<unsigned>(std::ceil(viewport.x / static_cast<float>(SCENE_SIZE.x)));
+    }
+}
+
+RenderScale::RenderScale(unsigned maxScale, bool bSmooth, sf::Vector2u windowSize)
+: target_(std::make_unique<sf::RenderTexture>())
+, sprite_(std::make_unique<sf::Sprite>())
+, maxScale_(std::clamp(maxScale, 1u, MAX_SCALE))
+, bSmooth_(bSmooth)
+{
+    resize(windowSize);
+}
+
+RenderScale::~RenderScale() = default;
+
+void RenderScale::resize(sf::Vector2u windowSize)
+{
+    const unsigned scale = std::clamp(getWindowScale(windowSize), 1u, maxScale_);
+    if(scale != scale_) create(scale);
+}
+
+sf::RenderTarget& RenderScale::begin()
+{
+    target_->clear();
+    return *target_;
+}
+
+void RenderScale::end()
+{
+    target_->display();
+}
+
+void RenderScale::release()
+{
+    (void)target_->setActive(false);
+}
+
+void RenderScale::present(sf::RenderTarget& window) const
+{
+    const sf::View originalView = window.getView();
+    window.setView(AspectRatio::getViewportAspectRatio(target_->getSize(), window.getSize(), AspectRatio::EAspectRatioRule::FitToParent));
+    window.draw(*sprite_);
+    window.setView(originalView);
+}
+
+sf::Vector2u RenderScale::getSize() const
+{
+    return target_->getSize();
+}
+
+unsigned RenderScale::probe(unsigned maxScale, unsigned frameRate)
+{
+    const float budget = PROBE_BUDGET / static_cast<float>(std::max(frameRate, 1u));
+
+    // Blended textured quads, the bulk of what scenes draw
+    sf::Texture texture;
+    if(!texture.create(64, 64)) return 1;
+    texture.setRepeated(true);
+
+    unsigned best = 1;
+    for(unsigned scale = 1; scale <= std::min(maxScale, MAX_SCALE); scale++)
+    {
+        sf::RenderTexture target;
+        if(!target.create(SCENE_SIZE.x * scale, SCENE_SIZE.y * scale)) break;
+
+        target.setView(sf::View({ 0.f, 0.f, static_cast<float>(SCENE_SIZE.x), static_cast<float>(SCENE_SIZE.y) }));
+
+        sf::RectangleShape quad({ static_cast<float>(SCENE_SIZE.x), static_cast<float>(SCENE_SIZE.y) });
+        quad.setTexture(&texture);
+        quad.setFillColor(sf::Color(255, 255, 255, 128));
+
+        const auto fill = [&](){
+            target.clear();
+            for(unsigned i = 0; i < PROBE_LAYERS; i++) target.draw(quad);
+            target.display();
+            glFinish();
+        };
+
+        // First frame also pays allocation of the target
+        fill();
+
+        sf::Clock clock;
+        fill();
+        if(clock.getElapsedTime().asSeconds() > budget) break;
+
+        best = scale;
+    }
+
+    return best;
+}
+
+void RenderScale::create(unsigned scale)
+{
+    if(!target_->create(SCENE_SIZE.x * scale, SCENE_SIZE.y * scale)) throw render_scale_exception();
+
+    target_->setSmooth(bSmooth_);
+    sprite_->setTexture(target_->getTexture(), true);
+    scale_ = scale;
+}
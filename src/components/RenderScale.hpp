@@ -0,0 +1,114 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <exception>
+#include <memory>
+
+#include <SFML/System/Vector2.hpp>
+
+namespace sf
+{
+    class RenderTarget;
+    class RenderTexture;
+    class Sprite;
+}
+
+namespace lpm
+{
+    class render_scale_exception final : public std::exception { };
+
+    /**
+     * @brief Offscreen target scenes are drawn into, upscaled to the window in one pass.
+     *
+     * Scenes are laid out in Configuration::BACKGROUND_TEX_SIZE units. Drawing them straight into the window
+     * rasterizes every node at window resolution, so fill cost grows with the window. Drawn into a target of a
+     * fixed multiple of the background size instead, the cost only depends on that multiple, and the window pays a
+     * single textured quad.
+     *
+     * The multiple follows the window, never beyond what it can show nor beyond maxScale. probe() measures the
+     * fill rate of the GPU to choose maxScale.
+     */
+    class RenderScale
+    {
+    public:
+        static constexpr unsigned MAX_SCALE    = 4;
+        static constexpr unsigned PROBE_LAYERS = 8;      //< Full scene quads drawn per probe, as a busy scene
+        static constexpr float PROBE_BUDGET    = .5f;    //< Share of a frame scenes may spend filling pixels
+
+    public:
+        /**
+         * @param maxScale Biggest multiple of background size used
+         * @param bSmooth Linear upscale, nearest pixel otherwise
+         * @throw render_scale_exception if target can't be created
+         */
+        RenderScale(unsigned maxScale, bool bSmooth, sf::Vector2u windowSize);
+        ~RenderScale();
+
+    public:
+        /**
+         * Recreate target if window needs another multiple
+         * @throw render_scale_exception if target can't be created
+         */
+        void resize(sf::Vector2u windowSize);
+
+        /**
+         * Get cleared target to draw this frame's scene into
+         */
+        [[nodiscard]] sf::RenderTarget& begin();
+
+        /**
+         * Finish drawing into target, on the thread that drew
+         */
+        void end();
+
+        /**
+         * Deactivate target on this thread, so another thread can draw into it
+         */
+        void release();
+
+        /**
+         * Draw scene drawn between begin() and end() into window, fit as scenes are
+         */
+        void present(sf::RenderTarget& window) const;
+
+        [[nodiscard]] unsigned getScale() const { return scale_; }
+        [[nodiscard]] unsigned getMaxScale() const { return maxScale_; }
+        [[nodiscard]] sf::Vector2u getSize() const;
+
+        /**
+         * Find biggest multiple of background size the GPU fills within PROBE_BUDGET of a frame. Needs a context.
+         * @return Multiple between 1 and maxScale
+         */
+        [[nodiscard]] static unsigned probe(unsigned maxScale, unsigned frameRate);
+
+    private:
+        void create(unsigned scale);
+
+    private:
+        std::unique_ptr<sf::RenderTexture> target_;
+        std::unique_ptr<sf::Sprite> sprite_;
+        unsigned maxScale_;
+        unsigned scale_ = 0;
+        bool bSmooth_;
+    };
+}
@@ -0,0 +1,86 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "ServerIDIndex.hpp"
+
+#include <bit>
+#include <cassert>
+
+using namespace lpm;
+
+ServerIDIndex::ServerIDIndex(size_t capacity)
+: entries_(std::bit_ceil(capacity * 2), Entry{EMPTY_SERVER_ID, INVALID_SLOT})
+{
+}
+
+void ServerIDIndex::insert(uint64_t serverId, uint16_t slot)
+{
+    assert(serverId != EMPTY_SERVER_ID && "Server id reserved by ServerIDIndex");
+    assert(findEntry(serverId) == entries_.size() && "Server id is already indexed");
+
+    auto position = hashServerID(serverId);
+    while(entries_[position].serverId != EMPTY_SERVER_ID)
+    {
+        position = (position + 1) & (entries_.size() - 1);
+    }
+    entries_[position] = { serverId, slot };
+}
+
+bool ServerIDIndex::erase(uint64_t serverId)
+{
+    auto position = findEntry(serverId);
+    if(position == entries_.size()) return false;
+
+    // Backward shift deletion: pull following entries of the cluster so lookups never need tombstones
+    const size_t mask = entries_.size() - 1;
+    for(size_t next = (position + 1) & mask; entries_[next].serverId != EMPTY_SERVER_ID; next = (next + 1) & mask)
+    {
+        const size_t ideal = hashServerID(entries_[next].serverId);
+        if(((next - ideal) & mask) >= ((next - position) & mask))
+        {
+            entries_[position] = entries_[next];
+            position = next;
+        }
+    }
+    entries_[position] = { EMPTY_SERVER_ID, INVALID_SLOT };
+    return true;
+}
+
+uint16_t ServerIDIndex::find(uint64_t serverId) const
+{
+    const auto position = findEntry(serverId);
+    return position != entries_.size() ? entries_[position].slot : INVALID_SLOT;
+}
+
+size_t ServerIDIndex::findEntry(uint64_t serverId) const
+{
+    for(auto position = hashServerID(serverId);; position = (position + 1) & (entries_.size() - 1))
+    {
+        if(entries_[position].serverId == serverId)        return position;
+        if(entries_[position].serverId == EMPTY_SERVER_ID) return entries_.size();
+    }
+}
+
+size_t ServerIDIndex::hashServerID(uint64_t serverId) const
+{
+    // Fibonacci hashing spreads sequential server ids across the table
+    return static_cast<size_t>((serverId * 0x9E3779B97F4A7C15ull) >> 32) & (entries_.size() - 1);
+}
@@ -0,0 +1,78 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace lpm
+{
+    /**
+     * @brief Map of server ids to HandlePool slots.
+     *
+     * Open addressing with linear probing in a power of two table twice the capacity, so clusters stay short.
+     * Erasing shifts the rest of the cluster back instead of leaving tombstones. The table is allocated in the
+     * constructor and never grows.
+     */
+    class ServerIDIndex
+    {
+    public:
+        static constexpr uint64_t EMPTY_SERVER_ID = std::numeric_limits<uint64_t>::max(); //< Can't be indexed
+        static constexpr uint16_t INVALID_SLOT = std::numeric_limits<uint16_t>::max();
+
+    public:
+        explicit ServerIDIndex(size_t capacity);
+
+    public:
+        /**
+         * Add a server id. It must not be indexed already and the index must be below capacity.
+         */
+        void insert(uint64_t serverId, uint16_t slot);
+
+        /**
+         * Remove a server id
+         * @return False if it wasn't indexed
+         */
+        bool erase(uint64_t serverId);
+
+        /**
+         * @return Slot of server id, INVALID_SLOT if it isn't indexed
+         */
+        [[nodiscard]] uint16_t find(uint64_t serverId) const;
+
+    private:
+        struct Entry
+        {
+            uint64_t serverId;
+            uint16_t slot;
+        };
+
+    private:
+        [[nodiscard]] size_t findEntry(uint64_t serverId) const;
+        [[nodiscard]] size_t hashServerID(uint64_t serverId) const;
+
+    private:
+        std::vector<Entry> entries_;
+    };
+}
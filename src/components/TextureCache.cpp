@@ -0,0 +1,164 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "TextureCache.hpp"
+#include "MappedFile.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Texture.hpp>
+
+#include <Configuration.hpp>
+
+using namespace lpm;
+
+namespace
+{
+    /**
+     * FNV-1a over 8 byte words, the source is hashed on every load so it must be much faster than decoding it
+     */
+    uint64_t hashContent(std::span<const std::byte> bytes)
+    {
+        constexpr uint64_t PRIME = 0x100000001B3;
+        uint64_t hash = 0xCBF29CE484222325;
+
+        size_t i = 0;
+        for(; i + sizeof(uint64_t) <= bytes.size(); i += sizeof(uint64_t))
+        {
+            uint64_t word;
+            std::memcpy(&word, bytes.data() + i, sizeof(word));
+            hash = (hash ^ word) * PRIME;
+        }
+        for(; i < bytes.size(); i++)
+        {
+            hash = (hash ^ static_cast<uint64_t>(bytes[i])) * PRIME;
+        }
+
+        return hash;
+    }
+}
+
+bool TextureCache::loadTexture(std::string_view fileName, sf::Texture& texture)
+{
+    MappedFile source;
+    if(!source.open(fileName)) return false;
+
+    const uint64_t hash = hashContent(source.getBytes());
+
+    MappedFile entry;
+    const Header* header = nullptr;
+    if(const auto* pixels = find(source, hash, entry, header); pixels && texture.create(header->width, header->height))
+    {
+        texture.update(pixels);
+        return true;
+    }
+
+    sf::Image image;
+    if(!image.loadFromMemory(source.data(), source.size())) return false;
+
+    store(source, hash, image);
+    return texture.loadFromImage(image);
+}
+
+bool TextureCache::loadImage(std::string_view fileName, sf::Image& image)
+{
+    MappedFile source;
+    if(!source.open(fileName)) return false;
+
+    const uint64_t hash = hashContent(source.getBytes());
+
+    MappedFile entry;
+    const Header* header = nullptr;
+    if(const auto* pixels = find(source, hash, entry, header))
+    {
+        image.create(header->width, header->height, pixels);
+        return true;
+    }
+
+    if(!image.loadFromMemory(source.data(), source.size())) return false;
+
+    store(source, hash, image);
+    return true;
+}
+
+const uint8_t* TextureCache::find(const MappedFile& source, uint64_t hash, MappedFile& entry, const Header*& header)
+{
+    if(!Configuration::TEXTURE_CACHE_DIR || !entry.open(getEntryPath(hash))) return nullptr;
+    if(entry.size() < sizeof(Header)) return nullptr;
+
+    header = reinterpret_cast<const Header*>(entry.data());
+    const size_t pixelBytes = static_cast<size_t>(header->width) * header->height * 4;
+
+    // Entry written by an older version, interrupted, or a hash collision
+    if(header->magic != MAGIC || header->version != VERSION || header->sourceHash != hash
+    || header->sourceSize != source.size() || entry.size() != sizeof(Header) + pixelBytes)
+    {
+        return nullptr;
+    }
+
+    return reinterpret_cast<const uint8_t*>(entry.data() + sizeof(Header));
+}
+
+void TextureCache::store(const MappedFile& source, uint64_t hash, const sf::Image& image)
+{
+    if(!Configuration::TEXTURE_CACHE_DIR) return;
+
+    std::error_code error;
+    std::filesystem::create_directories(Configuration::TEXTURE_CACHE_DIR, error);
+
+    const auto size = image.getSize();
+    const Header header{ MAGIC, VERSION, size.x, size.y, hash, source.size() };
+
+    // Written aside and renamed, so other threads or an interrupted run never map half an entry
+    const auto path = getEntryPath(hash);
+    std::ostringstream temporary;
+    temporary << path << '.' << std::this_thread::get_id() << ".tmp";
+
+    {
+        std::ofstream file(temporary.str(), std::ios::binary);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(image.getPixelsPtr()), static_cast<std::streamsize>(size.x) * size.y * 4);
+        if(!file)
+        {
+            std::cerr << "Can't write texture cache entry \042" << temporary.str() << "\042\n";
+            file.close();
+            std::filesystem::remove(temporary.str(), error);
+            return;
+        }
+    }
+
+    std::filesystem::rename(temporary.str(), path, error);
+    if(error) std::filesystem::remove(temporary.str(), error);
+}
+
+std::string TextureCache::getEntryPath(uint64_t hash)
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.rgba", static_cast<unsigned long long>(hash));
+    return (std::filesystem::path(Configuration::TEXTURE_CACHE_DIR) / name).string();
+}
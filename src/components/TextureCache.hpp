@@ -0,0 +1,87 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace sf
+{
+    class Image;
+    class Texture;
+}
+
+namespace lpm
+{
+    class MappedFile;
+
+    /**
+     * @brief Disk cache of decoded images.
+     *
+     * Decoding PNG and JPEG is most of the startup time. The first time an image is loaded its RGBA pixels are stored
+     * in Configuration::TEXTURE_CACHE_DIR, named by a hash of the source file content, so an edited image gets a new
+     * entry and a stale one is never used. Next loads map the entry and upload it as is.
+     *
+     * Entries are a small header followed by raw pixels, so they can be uploaded straight from the mapping. Stateless,
+     * safe to use from any thread. Without cache directory it just decodes.
+     */
+    class TextureCache
+    {
+    public:
+        static constexpr uint32_t MAGIC   = 0x54504C4D;     //< "LPMT"
+        static constexpr uint32_t VERSION = 1;
+
+        /**
+         * Load image file into texture
+         * @return False if file can't be read or decoded
+         */
+        static bool loadTexture(std::string_view fileName, sf::Texture& texture);
+
+        /**
+         * Load image file into image, e.g. from a loader thread
+         * @return False if file can't be read or decoded
+         */
+        static bool loadImage(std::string_view fileName, sf::Image& image);
+
+    private:
+        struct Header
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t width;
+            uint32_t height;
+            uint64_t sourceHash;
+            uint64_t sourceSize;
+        };
+
+        /**
+         * Map entry of source
+         * @return Pixels of entry, null if there is none or it doesn't match the source
+         */
+        static const uint8_t* find(const MappedFile& source, uint64_t hash, MappedFile& entry, const Header*& header);
+
+        static void store(const MappedFile& source, uint64_t hash, const sf::Image& image);
+
+        [[nodiscard]] static std::string getEntryPath(uint64_t hash);
+    };
+}
@@ -21,24 +21,414 @@
 
 #include "DebugNetwork.hpp"
 
+#include <algorithm>
+#include <cmath>
+
+#include <imgui.h>
+
+#include <Configuration.hpp>
+
 using namespace lpm;
 
+namespace
+{
+    constexpr std::string_view CAMERAS[] = { "AL_Almacen1.jpg", "AL_Almacen2.jpg", "AL_Almacen3.jpg" };
+
+    constexpr std::string_view PHRASES[] = {
+        "hola",
+        "alguien sabe como salir de aqui?",
+        "lol",
+        "esta sala da miedo",
+        "nos vemos en el patio",
+        "que hora es?",
+        "jajaja",
+        "he encontrado una llave!"
+    };
+
+    constexpr std::string_view ITEMS[] = { "key", "book", "spoon", "letter" };
+
+    constexpr float MIN_SPEED = 60.f;
+    constexpr float MAX_SPEED = 240.f;
+    constexpr float MAX_WAIT  = 3.f;     //< Longest pause after reaching a target
+    constexpr float MAX_AWAY  = 10.f;    //< Longest time outside the room before coming back
+}
+
+DebugNetwork::DebugNetwork()
+: DebugNetwork(CrowdSettings{})
+{
+
+}
+
+DebugNetwork::DebugNetwork(const CrowdSettings& settings)
+: settings_(settings)
+, random_(settings.seed)
+{
+
+}
+
 void DebugNetwork::init()
 {
+    events_.publish(NetworkEvent::Connected{});
+    events_.publish(NetworkEvent::LoginStatus{ true });
+
+    spawnCrowd();
+}
+
+void DebugNetwork::update(float deltaTime)
+{
+    backlog_ = std::max(0.f, backlog_ - settings_.uplink * deltaTime);
+
+    for(auto& player : crowd_)
+    {
+        if(!player.bInRoom)
+        {
+            player.wait -= deltaTime;
+            if(player.wait <= 0.f) enterRoom(player);
+            continue;
+        }
+
+        if(chance(settings_.roomChurn, deltaTime))
+        {
+            leaveRoom(player);
+            continue;
+        }
+
+        if(chance(settings_.cameraChurn, deltaTime))
+        {
+            const auto camera = static_cast<uint8_t>(std::uniform_int_distribution<unsigned>(0, std::size(CAMERAS) - 1)(random_));
+            changeCamera(player, camera);
+        }
+
+        walk(player, deltaTime);
+
+        if(chance(settings_.chatRate, deltaTime))
+        {
+            const auto phrase = std::uniform_int_distribution<size_t>(0, std::size(PHRASES) - 1)(random_);
+            if(const auto id = players_.find(player.serverId); id.isValid())
+            {
+                events_.publish(NetworkEvent::PlayerMessage{ id, PHRASES[phrase] });
+            }
+        }
+    }
+
+    updateItems(deltaTime);
+    updatePongs(deltaTime);
+    updateRoom(deltaTime);
+}
+
+bool DebugNetwork::transmit(const OutgoingMessage& message)
+{
+    // Requests are answered after a round trip, like a real server would
+    const float delay = settings_.latency + random(0.f, settings_.jitter);
+    switch(message.type)
+    {
+        case EOutgoing::Room:
+            room_ = message.getText();
+            roomDelay_ = delay;
+            break;
+        case EOutgoing::RoomSnapshot:
+            bSnapshotRequested_ = true;
+            snapshotDelay_ = delay;
+            break;
+        case EOutgoing::Camera:
+            camera_ = message.getText();
+            break;
+        case EOutgoing::Ping:
+            pongs_.push_back({ message.sequence, delay });
+            break;
+        case EOutgoing::Position:
+        case EOutgoing::Chat:
+        case EOutgoing::PrivateChat:
+            break;
+    }
+
+    if(settings_.uplink > 0.f)
+    {
+        backlog_ += static_cast<float>(message.getWireSize());
+    }
+    return true;
+}
+
+size_t DebugNetwork::getTransportBacklog() const
+{
+    return static_cast<size_t>(backlog_);
+}
+
+void DebugNetwork::drawDebug()
+{
+    ImGui::Begin("Debug - Crowd");
+
+    auto settings = settings_;
+    int players = static_cast<int>(settings.players);
+    ImGui::SliderInt("Players", &players, 0, static_cast<int>(PlayerRegistry::DEFAULT_CAPACITY));
+    ImGui::SliderFloat("Room churn", &settings.roomChurn, 0.f, 1.f);
+    ImGui::SliderFloat("Camera churn", &settings.cameraChurn, 0.f, 1.f);
+    ImGui::SliderFloat("Position rate", &settings.positionRate, 0.f, 60.f);
+    ImGui::SliderFloat("Chat rate", &settings.chatRate, 0.f, 1.f);
+    ImGui::SliderFloat("Item spawn rate", &settings.itemSpawnRate, 0.f, 10.f);
+    ImGui::SliderFloat("Item lifetime", &settings.itemLifetime, 1.f, 60.f);
+    ImGui::SliderFloat("Latency", &settings.latency, 0.f, 1.f);
+    ImGui::SliderFloat("Jitter", &settings.jitter, 0.f, 1.f);
+    ImGui::SliderFloat("Delta loss", &settings.deltaLoss, 0.f, 1.f);
+    ImGui::SliderFloat("Uplink", &settings.uplink, 0.f, 64.f * 1024.f);
+    settings.players = static_cast<unsigned>(players);
+
+    // Rates apply on the fly, a new crowd size or seed respawns the crowd
+    if(ImGui::Button("Respawn")) settings.seed++;
+
+    if(settings.players != settings_.players || settings.seed != settings_.seed)
+    {
+        setCrowdSettings(settings);
+    }
+    else
+    {
+        settings_ = settings;
+    }
+
+    ImGui::Separator();
+    ImGui::LabelText("Players", "%u", static_cast<unsigned>(players_.size()));
+    ImGui::LabelText("Items", "%u", static_cast<unsigned>(items_.size()));
+    ImGui::LabelText("Events", "%u", static_cast<unsigned>(events_.getLastDispatchCount()));
+    ImGui::LabelText("Dropped", "%u", static_cast<unsigned>(events_.getDroppedCount()));
+    ImGui::LabelText("Membership", "v%u, %u gaps, %u snapshots",
+        membership_.getVersion(),
+        static_cast<unsigned>(membership_.getGapCount()),
+        static_cast<unsigned>(membership_.getSnapshotCount())
+    );
+    ImGui::LabelText("Uplink backlog", "%u bytes", static_cast<unsigned>(backlog_));
+
+    ImGui::End();
+}
+
+void DebugNetwork::setCrowdSettings(const CrowdSettings& settings)
+{
+    despawnCrowd();
+
+    settings_ = settings;
+    random_.seed(settings.seed);
+
+    spawnCrowd();
+}
+
+//~====================================================================================================================
+// Crowd
+
+void DebugNetwork::spawnCrowd()
+{
+    crowd_.resize(settings_.players);
+    for(auto& player : crowd_)
+    {
+        enterRoom(player);
+    }
+}
+
+void DebugNetwork::despawnCrowd()
+{
+    for(auto& player : crowd_)
+    {
+        if(player.bInRoom) leaveRoom(player);
+    }
+    crowd_.clear();
+
+    for(const auto& item : items_)
+    {
+        events_.publish(NetworkEvent::DestroyItem{ item.id });
+    }
+    items_.clear();
+}
+
+void DebugNetwork::enterRoom(FakePlayer& player)
+{
+    // Each visit is a new connection with its own server id
+    player.serverId = nextServerId_++;
+    player.bInRoom = true;
+    sendDelta({ 0, RoomMembership::EChange::Add, player.serverId, getName(player.serverId) });
+
+    player.posX = random(0.f, static_cast<float>(Configuration::BACKGROUND_TEX_SIZE_X));
+    player.posY = random(0.f, static_cast<float>(Configuration::BACKGROUND_TEX_SIZE_Y));
+    player.nextPosition = 0.f;
+    pickTarget(player);
+
+    player.camera = static_cast<uint8_t>(std::uniform_int_distribution<unsigned>(0, std::size(CAMERAS) - 1)(random_));
+    if(const auto id = players_.find(player.serverId); id.isValid())
+    {
+        events_.publish(NetworkEvent::PlayerEnterCamera{ id, CAMERAS[player.camera] });
+    }
+}
+
+void DebugNetwork::leaveRoom(FakePlayer& player)
+{
+    sendDelta({ 0, RoomMembership::EChange::Remove, player.serverId, {} });
+    player.bInRoom = false;
+    player.wait = random(0.f, MAX_AWAY);
+}
+
+void DebugNetwork::changeCamera(FakePlayer& player, uint8_t camera)
+{
+    if(camera == player.camera) return;
+
+    if(const auto id = players_.find(player.serverId); id.isValid())
+    {
+        events_.publish(NetworkEvent::PlayerLeaveCamera{ id, CAMERAS[player.camera] });
+        events_.publish(NetworkEvent::PlayerEnterCamera{ id, CAMERAS[camera] });
+    }
+    player.camera = camera;
+}
+
+void DebugNetwork::sendDelta(RoomMembership::Delta delta)
+{
+    // Version advances even if the diff is lost, that's how the client notices
+    delta.version = ++membershipVersion_;
+    if(random(0.f, 1.f) >= settings_.deltaLoss) membership_.applyDelta(delta);
+}
+
+void DebugNetwork::sendSnapshot()
+{
+    // Names first, views into the string are taken once it stops growing
+    snapshotNames_.clear();
+    for(const auto& player : crowd_)
+    {
+        if(player.bInRoom) snapshotNames_ += getName(player.serverId);
+    }
+
+    snapshot_.clear();
+    size_t offset = 0;
+    for(const auto& player : crowd_)
+    {
+        if(!player.bInRoom) continue;
+
+        const auto length = getName(player.serverId).size();
+        snapshot_.push_back({ player.serverId, std::string_view(snapshotNames_).substr(offset, length) });
+        offset += length;
+    }
+
+    membership_.applySnapshot(membershipVersion_, snapshot_);
+}
+
+std::string DebugNetwork::getName(uint64_t serverId)
+{
+    return "bot" + std::to_string(serverId);
+}
+
+void DebugNetwork::walk(FakePlayer& player, float deltaTime)
+{
+    if(player.wait > 0.f)
+    {
+        player.wait -= deltaTime;
+    }
+    else
+    {
+        const float dx = player.targetX - player.posX;
+        const float dy = player.targetY - player.posY;
+        const float distance = std::sqrt(dx * dx + dy * dy);
+        const float step = player.speed * deltaTime;
+
+        if(distance <= step)
+        {
+            player.posX = player.targetX;
+            player.posY = player.targetY;
+            player.wait = random(0.f, MAX_WAIT);
+            pickTarget(player);
+        }
+        else
+        {
+            player.posX += dx / distance * step;
+            player.posY += dy / distance * step;
+        }
+    }
+
+    if(settings_.positionRate <= 0.f) return;
+
+    player.nextPosition -= deltaTime;
+    if(player.nextPosition <= 0.f)
+    {
+        player.nextPosition += 1.f / settings_.positionRate;
+        player.nextPosition = std::max(player.nextPosition, 0.f);
+        if(const auto id = players_.find(player.serverId); id.isValid())
+        {
+            events_.publish(NetworkEvent::PlayerPosition{
+                id,
+                static_cast<unsigned>(player.posX),
+                static_cast<unsigned>(player.posY)
+            });
+        }
+    }
+}
+
+void DebugNetwork::pickTarget(FakePlayer& player)
+{
+    // Mostly short strolls around current position, sometimes a walk across the room
+    const float range = chance(1.f, 0.2f) ? static_cast<float>(Configuration::BACKGROUND_TEX_SIZE_X) : 120.f;
 
+    player.targetX = std::clamp(player.posX + random(-range, range), 0.f, static_cast<float>(Configuration::BACKGROUND_TEX_SIZE_X - 1));
+    player.targetY = std::clamp(player.posY + random(-range, range), 0.f, static_cast<float>(Configuration::BACKGROUND_TEX_SIZE_Y - 1));
+    player.speed = random(MIN_SPEED, MAX_SPEED);
 }
 
-void DebugNetwork::changeRoom(class RoomSceneNode* /*room*/)
+void DebugNetwork::updateItems(float deltaTime)
 {
-    
+    for(auto& item : items_)
+    {
+        item.lifetime -= deltaTime;
+    }
+
+    const auto expired = std::partition(items_.begin(), items_.end(), [](const FakeItem& item){ return item.lifetime > 0.f; });
+    for(auto it = expired; it != items_.end(); ++it)
+    {
+        events_.publish(NetworkEvent::DestroyItem{ it->id });
+    }
+    items_.erase(expired, items_.end());
+
+    // An idle server spawns nothing, items are part of the crowd
+    if(!crowd_.empty() && chance(settings_.itemSpawnRate, deltaTime))
+    {
+        const FakeItem item { nextItemId_++, settings_.itemLifetime };
+        const auto name = ITEMS[std::uniform_int_distribution<size_t>(0, std::size(ITEMS) - 1)(random_)];
+        const auto posX = static_cast<unsigned>(random(0.f, static_cast<float>(Configuration::BACKGROUND_TEX_SIZE_X - 1)));
+        const auto posY = static_cast<unsigned>(random(0.f, static_cast<float>(Configuration::BACKGROUND_TEX_SIZE_Y - 1)));
+
+        if(events_.publish(NetworkEvent::SpawnItem{ item.id, name, posX, posY })) items_.push_back(item);
+    }
+}
+
+void DebugNetwork::updatePongs(float deltaTime)
+{
+    for(auto& pong : pongs_)
+    {
+        pong.delay -= deltaTime;
+        if(pong.delay <= 0.f && events_.publish(NetworkEvent::Pong{ pong.sequence })) pong.sequence = 0;
+    }
+    std::erase_if(pongs_, [](const PendingPong& pong){ return pong.sequence == 0; });
+}
+
+void DebugNetwork::updateRoom(float deltaTime)
+{
+    if(bSnapshotRequested_)
+    {
+        snapshotDelay_ -= deltaTime;
+        if(snapshotDelay_ <= 0.f)
+        {
+            bSnapshotRequested_ = false;
+            sendSnapshot();
+        }
+    }
+
+    if(room_.empty()) return;
+
+    roomDelay_ -= deltaTime;
+    if(roomDelay_ > 0.f || !events_.publish(NetworkEvent::RoomChanged{ room_, true })) return;
+    room_.clear();
+
+    // Joining a room starts with its full member list
+    sendSnapshot();
 }
 
-void DebugNetwork::sendMessage(class Player* /*player*/, const char* /*message*/)
+bool DebugNetwork::chance(float rate, float deltaTime)
 {
-    
+    return std::uniform_real_distribution<float>(0.f, 1.f)(random_) < rate * deltaTime;
 }
 
-void DebugNetwork::sendMessage(const char* /*message*/)
+float DebugNetwork::random(float min, float max)
 {
-    
+    return std::uniform_real_distribution<float>(min, max)(random_);
 }
@@ -21,16 +21,131 @@
 
 #pragma once
 
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
 #include <network/INetwork.hpp>
 
 namespace lpm
 {
+    /**
+     * @brief Socket-free network that simulates a crowd.
+     *
+     * Fake players enter and leave the room, walk between cameras, move their cursors, chat, and items are spawned
+     * and destroyed, all published through the same bus real traffic uses. Everything is driven by a seeded random
+     * generator stepped in update(), so the same settings and frame times produce the same session.
+     * With 0 players it behaves as an idle server that accepts every request.
+     */
     class DebugNetwork : public INetwork
     {
+    public:
+        /**
+         * Crowd parameters. Rates are per second.
+         */
+        struct CrowdSettings
+        {
+            unsigned players    = 0;        //< Fake players, 0 disables the crowd
+            float roomChurn     = 0.02f;    //< Chance of each player to leave the room, it comes back later
+            float cameraChurn   = 0.05f;    //< Chance of each player to walk into another camera
+            float positionRate  = 10.f;     //< Cursor updates sent by each player
+            float chatRate      = 0.02f;    //< Messages sent by each player
+            float itemSpawnRate = 0.5f;     //< Items spawned in the room while there is a crowd
+            float itemLifetime  = 20.f;     //< Seconds before an item is destroyed
+            float latency       = 0.06f;    //< Seconds before a ping is answered
+            float jitter        = 0.03f;    //< Random extra latency, up to this many seconds
+            float deltaLoss     = 0.f;      //< Chance of losing a membership diff, forcing a snapshot
+            float uplink        = 0.f;      //< Bytes per second sent to server, 0 is unlimited
+            uint32_t seed       = 1;        //< Seed of the session
+        };
+
+    public:
+        DebugNetwork();
+        explicit DebugNetwork(const CrowdSettings& settings);
+
     public:
         void init() override;
-        void changeRoom(class RoomSceneNode* room) override;
-        void sendMessage(class Player* player, const char* message) override;
-        void sendMessage(const char* message) override;
+        void update(float deltaTime) override;
+        void drawDebug() override;
+
+    public:
+        /**
+         * Replace crowd. Current fake players leave and items are destroyed, then a new crowd is spawned.
+         */
+        void setCrowdSettings(const CrowdSettings& settings);
+        [[nodiscard]] const CrowdSettings& getCrowdSettings() const { return settings_; }
+
+    protected:
+        bool transmit(const OutgoingMessage& message) override;
+        [[nodiscard]] size_t getTransportBacklog() const override;
+
+    private:
+        struct FakePlayer
+        {
+            uint64_t serverId = 0;
+            bool bInRoom = false;
+            float posX = 0.f, posY = 0.f;
+            float targetX = 0.f, targetY = 0.f;
+            float speed = 0.f;              //< Pixels per second
+            float wait = 0.f;               //< Seconds standing still, or outside the room
+            float nextPosition = 0.f;       //< Seconds until next position update
+            uint8_t camera = 0;
+        };
+
+        struct FakeItem
+        {
+            uint32_t id = 0;
+            float lifetime = 0.f;
+        };
+
+        struct PendingPong
+        {
+            uint32_t sequence = 0;
+            float delay = 0.f;              //< Seconds until answered
+        };
+
+        void spawnCrowd();
+        void despawnCrowd();
+
+        void enterRoom(FakePlayer& player);
+        void leaveRoom(FakePlayer& player);
+        void changeCamera(FakePlayer& player, uint8_t camera);
+        void sendDelta(RoomMembership::Delta delta);
+        void sendSnapshot();
+        [[nodiscard]] static std::string getName(uint64_t serverId);
+        void walk(FakePlayer& player, float deltaTime);
+        void pickTarget(FakePlayer& player);
+
+        void updateItems(float deltaTime);
+        void updatePongs(float deltaTime);
+        void updateRoom(float deltaTime);
+
+        /**
+         * Roll an event happening rate times per second
+         */
+        [[nodiscard]] bool chance(float rate, float deltaTime);
+        [[nodiscard]] float random(float min, float max);
+
+    private:
+        CrowdSettings settings_;
+        std::mt19937 random_;
+
+        std::vector<FakePlayer> crowd_;
+        std::vector<FakeItem> items_;
+        std::vector<PendingPong> pongs_;
+        std::vector<RoomMembership::Member> snapshot_;
+        std::string snapshotNames_;         //< Storage of snapshot_ names
+
+        std::string camera_;                //< Camera watched by the client
+        std::string room_;                  //< Room requested by the client, empty if none
+        float roomDelay_ = 0.f;             //< Seconds until room change is answered
+        float snapshotDelay_ = 0.f;         //< Seconds until snapshot request is answered
+        bool bSnapshotRequested_ = false;
+        float backlog_ = 0.f;               //< Bytes sent by the client still on the simulated uplink
+        uint32_t membershipVersion_ = 0;    //< Version of the room membership kept by the simulated server
+        uint64_t nextServerId_ = 1;
+        uint32_t nextItemId_ = 1;
     };
 }
@@ -0,0 +1,89 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "INetwork.hpp"
+
+using namespace lpm;
+
+bool INetwork::changeRoom(std::string_view room)
+{
+    OutgoingMessage message;
+    message.type = EOutgoing::Room;
+    message.setText(room);
+    return send(message);
+}
+
+bool INetwork::requestRoomSnapshot()
+{
+    OutgoingMessage message;
+    message.type = EOutgoing::RoomSnapshot;
+    return send(message);
+}
+
+bool INetwork::changeCamera(std::string_view camera)
+{
+    OutgoingMessage message;
+    message.type = EOutgoing::Camera;
+    message.setText(camera);
+    return send(message);
+}
+
+bool INetwork::sendPosition(unsigned posX, unsigned posY)
+{
+    OutgoingMessage message;
+    message.type = EOutgoing::Position;
+    message.posX = posX;
+    message.posY = posY;
+    return send(message);
+}
+
+bool INetwork::sendMessage(PlayerID player, std::string_view text)
+{
+    // Handle may be stale by the time the message leaves, server only knows server ids anyway
+    if(!players_.isValid(player)) return false;
+
+    OutgoingMessage message;
+    message.type = EOutgoing::PrivateChat;
+    message.target = players_.getPlayer(player).getServerID();
+    message.setText(text);
+    return send(message);
+}
+
+bool INetwork::sendMessage(std::string_view text)
+{
+    OutgoingMessage message;
+    message.type = EOutgoing::Chat;
+    message.setText(text);
+    return send(message);
+}
+
+bool INetwork::sendPing(uint32_t sequence)
+{
+    OutgoingMessage message;
+    message.type = EOutgoing::Ping;
+    message.sequence = sequence;
+    return send(message);
+}
+
+bool INetwork::send(const OutgoingMessage& message)
+{
+    return outgoing_.push(message) != OutgoingQueue::EPushResult::Rejected;
+}
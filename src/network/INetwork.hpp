@@ -21,12 +21,12 @@
 
 #pragma once
 
-#include <vector>
+#include <string_view>
 
-#define DECLARE_OBSERVER(Name) void(*Name)()
-#define DECLARE_OBSERVER_OneParam(Name,Param1) void(*Name)(Param1)
-#define DECLARE_OBSERVER_TwoParam(Name,Param1,Param2) void(*Name)(Param1,Param2)
-#define DECLARE_OBSERVER_ThreeParam(Name,Param1,Param2,Param3) void(*Name)(Param1,Param2,Param3)
+#include <network/NetworkEvents.hpp>
+#include <network/NetworkTelemetry.hpp>
+#include <network/OutgoingQueue.hpp>
+#include <network/RoomMembership.hpp>
 
 namespace lpm
 {
@@ -37,52 +37,126 @@ namespace lpm
 
         virtual void init() = 0;
 
-        virtual void changeRoom(class RoomSceneNode* room) = 0;
-        virtual void sendMessage(class Player* player, const char* message) = 0;
-        virtual void sendMessage(const char* message) = 0;
+        /**
+         * Pump incoming traffic. Called once per frame, before dispatch.
+         */
+        virtual void update(float deltaTime) = 0;
+
+        /**
+         * Draw ImGui tools of the implementation. Only called in debug builds.
+         */
+        virtual void drawDebug() {}
+
+    public:
+        //~============================================================================================================
+        // Outgoing requests. They're queued in OutgoingQueue lanes and sent by tick().
+        // All of them return false if the lane is full and the request was rejected.
+
+        /**
+         * Ask server to move local player into room. Server answers with NetworkEvent::RoomChanged.
+         */
+        bool changeRoom(std::string_view room);
+
+        /**
+         * Ask server for the full member list of the room. Implementations pass it to RoomMembership::applySnapshot.
+         * Called when room membership lost track of the server version.
+         */
+        bool requestRoomSnapshot();
+
+        /**
+         * Ask for detailed updates of players inside camera. Players in other cameras of the room are only
+         * reported at presence rate.
+         */
+        bool changeCamera(std::string_view camera);
+
+        /**
+         * Send cursor position of local player. A position still queued is replaced by the new one.
+         */
+        bool sendPosition(unsigned posX, unsigned posY);
+
+        bool sendMessage(PlayerID player, std::string_view message);
+        bool sendMessage(std::string_view message);
+
+        /**
+         * Send ping to server. Implementations answer publishing NetworkEvent::Pong with the same sequence, those
+         * without a server round trip can ignore it.
+         */
+        bool sendPing(uint32_t sequence);
 
     public:
-        struct Observers
+        /**
+         * Pump incoming traffic and deliver it, accounting both in telemetry. Engine calls it once per frame.
+         */
+        void tick(float deltaTime)
+        {
+            using Clock = NetworkTelemetry::Clock;
+
+            const auto start = Clock::now();
+            update(deltaTime);
+            const auto updated = Clock::now();
+            dispatch(deltaTime);
+            const auto dispatched = Clock::now();
+
+            outgoing_.flush(deltaTime, getTransportBacklog(), OutgoingQueue::Transmit::bind<&INetwork::transmit>(this));
+
+            telemetry_.tick(deltaTime, updated - start, dispatched - updated);
+        }
+
+        /**
+         * Deliver events published since last frame and release players that left during them.
+         * Engine calls it once per frame.
+         */
+        void dispatch(float deltaTime)
         {
-            //
-            // Connection
-            // ~=======================================================================================
-            DECLARE_OBSERVER(Connected);
-            DECLARE_OBSERVER(Disconnected);
-            DECLARE_OBSERVER_OneParam(ConnectionError, const char* /*reason*/);
-            DECLARE_OBSERVER_OneParam(ConnectionKicked, const char* /*reason*/);
-            DECLARE_OBSERVER_OneParam(LoginStatus, bool /*success*/);
-            DECLARE_OBSERVER_OneParam(RoomChanged, class RoomSceneNode* /*success*/);
-
-            //
-            // Players
-            // ~=======================================================================================
-            DECLARE_OBSERVER_OneParam(PlayerEnterRoom, class Player* /*player*/);
-            DECLARE_OBSERVER_OneParam(PlayerLeaveRoom, class Player* /*player*/);
-            DECLARE_OBSERVER_TwoParam(PlayerEnterCamera, class Player* /*player*/, const char* /*camera*/);
-            DECLARE_OBSERVER_TwoParam(PlayerLeaveCamera, class Player* /*player*/, const char* /*camera*/);
-            DECLARE_OBSERVER_OneParam(PlayersRoomList, std::vector<class Player*> /*players*/);
-            DECLARE_OBSERVER_ThreeParam(PlayerPosition, class Player* /*player*/, unsigned /*posX*/, unsigned /*posY*/);
-
-            //
-            // Chat
-            // ~=======================================================================================
-            DECLARE_OBSERVER_OneParam(GlobalMessage, const char* /*message*/);
-            DECLARE_OBSERVER_TwoParam(PlayerMessage, class Player* /*player*/, const char* /*message*/);
-            DECLARE_OBSERVER_TwoParam(PrivateMessage, class Player* /*player*/, const char* /*message*/);
-
-            //
-            // Room
-            // ~=======================================================================================
-            DECLARE_OBSERVER_OneParam(RoomMessage, const char* /*message*/);
-            DECLARE_OBSERVER_OneParam(SpawnItem, class RoomItem* /*item*/);
-            DECLARE_OBSERVER_OneParam(DestroyItem, class RoomItem* /*item*/);
-
-        } observers_;
+            events_.dispatch();
+            players_.flushRemovals();
+            players_.tick(deltaTime);
+            membership_.tick(deltaTime);
+        }
+
+        /**
+         * Get bus where implementations publish NetworkEvent's. Engine dispatches it once per frame.
+         * @return Network event bus
+         */
+        [[nodiscard]] NetworkEventBus& getEvents() { return events_; }
+
+        /**
+         * Get remote players known by the network. PlayerID's in NetworkEvent's are resolved here.
+         * @return Player registry
+         */
+        [[nodiscard]] PlayerRegistry& getPlayers() { return players_; }
+
+        [[nodiscard]] NetworkTelemetry& getTelemetry() { return telemetry_; }
+
+        /**
+         * Get versioned membership of current room. Implementations feed it with the diffs received from server.
+         */
+        [[nodiscard]] RoomMembership& getMembership() { return membership_; }
+
+        /**
+         * Get lanes of outgoing traffic
+         */
+        [[nodiscard]] OutgoingQueue& getOutgoing() { return outgoing_; }
+
+    protected:
+        /**
+         * Hand message to transport. Called by tick() as rate limits allow, in priority order.
+         * @return False if transport can't take it now, it's retried next frame
+         */
+        virtual bool transmit(const OutgoingMessage& message) = 0;
+
+        /**
+         * Get bytes handed to transport and not sent yet. A growing backlog pauses low priority lanes.
+         */
+        [[nodiscard]] virtual size_t getTransportBacklog() const { return 0; }
+
+        bool send(const OutgoingMessage& message);
+
+    protected:
+        NetworkEventBus events_;
+        PlayerRegistry players_;
+        NetworkTelemetry telemetry_ {*this};
+        RoomMembership membership_ {*this};
+        OutgoingQueue outgoing_;
     };
 }
-
-#undef DECLARE_OBSERVER
-#undef DECLARE_OBSERVER_OneParam
-#undef DECLARE_OBSERVER_TwoParam
-#undef DECLARE_OBSERVER_ThreeParam
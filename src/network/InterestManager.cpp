@@ -0,0 +1,162 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "InterestManager.hpp"
+
+#include <components/Hash.hpp>
+#include <network/INetwork.hpp>
+
+using namespace lpm;
+
+InterestManager::InterestManager(INetwork& network)
+: network_(network)
+, players_(network.getPlayers())
+, detailedIndex_(network.getPlayers().capacity(), NOT_DETAILED)
+{
+    for(auto& detailed : detailed_)
+    {
+        detailed.reserve(players_.capacity());
+    }
+
+    auto& events = network_.getEvents();
+    subscriptions_ = {
+        events.subscribe<NetworkEvent::PlayerLeaveRoom>(NetworkEventBus::Handler<NetworkEvent::PlayerLeaveRoom>::bind<&InterestManager::onPlayerLeaveRoom>(this)),
+        events.subscribe<NetworkEvent::PlayerEnterCamera>(NetworkEventBus::Handler<NetworkEvent::PlayerEnterCamera>::bind<&InterestManager::onPlayerEnterCamera>(this)),
+        events.subscribe<NetworkEvent::PlayerLeaveCamera>(NetworkEventBus::Handler<NetworkEvent::PlayerLeaveCamera>::bind<&InterestManager::onPlayerLeaveCamera>(this)),
+        events.subscribe<NetworkEvent::PlayerPosition>(NetworkEventBus::Handler<NetworkEvent::PlayerPosition>::bind<&InterestManager::onPlayerPosition>(this))
+    };
+}
+
+InterestManager::~InterestManager()
+{
+    for(const auto subscription : subscriptions_)
+    {
+        network_.getEvents().unsubscribe(subscription);
+    }
+}
+
+void InterestManager::changeCamera(std::string_view camera)
+{
+    const uint32_t cameraHash = hashName(camera);
+
+    // Build back set walking the camera hot array of the registry
+    auto& back = detailed_[1 - front_];
+    back.clear();
+
+    const auto cameras = players_.getCameras();
+    for(size_t dense = 0; dense < cameras.size(); dense++)
+    {
+        if(cameras[dense] == cameraHash)
+        {
+            back.push_back(players_.getPlayerAt(dense));
+        }
+    }
+
+    // Swap
+    for(const auto player : detailed_[front_])
+    {
+        detailedIndex_[player.index] = NOT_DETAILED;
+    }
+    for(size_t i = 0; i < back.size(); i++)
+    {
+        detailedIndex_[back[i].index] = static_cast<uint16_t>(i);
+    }
+
+    front_  = 1 - front_;
+    camera_ = cameraHash;
+
+    network_.changeCamera(camera);
+}
+
+std::span<const PlayerID> InterestManager::getDetailedPlayers() const
+{
+    return detailed_[front_];
+}
+
+bool InterestManager::isDetailed(PlayerID player) const
+{
+    return players_.isValid(player) && detailedIndex_[player.index] != NOT_DETAILED;
+}
+
+void InterestManager::onPlayerLeaveRoom(const NetworkEvent::PlayerLeaveRoom& event)
+{
+    removeDetailed(event.player);
+}
+
+void InterestManager::onPlayerEnterCamera(const NetworkEvent::PlayerEnterCamera& event)
+{
+    const uint32_t cameraHash = hashName(event.camera);
+    players_.setCamera(event.player, cameraHash);
+
+    if(cameraHash == camera_) addDetailed(event.player);
+    else                      removeDetailed(event.player);
+}
+
+void InterestManager::onPlayerLeaveCamera(const NetworkEvent::PlayerLeaveCamera& event)
+{
+    if(players_.isValid(event.player) && players_.getCamera(event.player) == hashName(event.camera))
+    {
+        players_.setCamera(event.player, 0);
+    }
+    removeDetailed(event.player);
+}
+
+void InterestManager::onPlayerPosition(const NetworkEvent::PlayerPosition& event)
+{
+    if(!players_.isValid(event.player)) return;
+
+    if(!isDetailed(event.player))
+    {
+        const auto dense = players_.getDenseIndex(event.player);
+        if(players_.getTime() - players_.getLastUpdates()[dense] < PRESENCE_INTERVAL)
+        {
+            ++throttledCount_;
+            network_.getTelemetry().addCoalesced();
+            return;
+        }
+    }
+
+    players_.setPosition(event.player, { static_cast<float>(event.posX), static_cast<float>(event.posY) });
+}
+
+void InterestManager::addDetailed(PlayerID player)
+{
+    if(!players_.isValid(player) || detailedIndex_[player.index] != NOT_DETAILED) return;
+
+    auto& front = detailed_[front_];
+    detailedIndex_[player.index] = static_cast<uint16_t>(front.size());
+    front.push_back(player);
+}
+
+void InterestManager::removeDetailed(PlayerID player)
+{
+    if(!players_.isValid(player)) return;
+
+    const uint16_t index = detailedIndex_[player.index];
+    if(index == NOT_DETAILED) return;
+
+    auto& front = detailed_[front_];
+    front[index] = front.back();
+    detailedIndex_[front[index].index] = index;
+    front.pop_back();
+
+    detailedIndex_[player.index] = NOT_DETAILED;
+}
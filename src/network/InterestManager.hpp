@@ -0,0 +1,97 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <network/NetworkEvents.hpp>
+
+namespace lpm
+{
+    class INetwork;
+
+    /**
+     * @brief Client side interest management of remote players.
+     *
+     * Players inside the camera the local player is looking at are "detailed": every PlayerPosition is applied and
+     * they're drawn. The rest of the room only matters as presence, so their positions are accepted at most once
+     * per PRESENCE_INTERVAL. Per-frame work over players (interpolation, drawing...) should iterate
+     * getDetailedPlayers() instead of the whole PlayerRegistry, making it scale with what is on screen.
+     *
+     * The detailed set is double buffered. changeCamera builds the new set from the registry and swaps it in one go,
+     * so there's never a frame mixing players of two cameras.
+     */
+    class InterestManager
+    {
+    public:
+        static constexpr float PRESENCE_INTERVAL = 1.f;
+
+    public:
+        explicit InterestManager(INetwork& network);
+        ~InterestManager();
+
+        InterestManager(const InterestManager&) = delete;
+        InterestManager& operator=(const InterestManager&) = delete;
+
+    public:
+        /**
+         * Switch detailed set to players inside camera and notify the network
+         */
+        void changeCamera(std::string_view camera);
+
+        [[nodiscard]] std::span<const PlayerID> getDetailedPlayers() const;
+        [[nodiscard]] bool isDetailed(PlayerID player) const;
+        [[nodiscard]] uint32_t getCamera() const { return camera_; }
+
+        /**
+         * Get number of PlayerPosition updates ignored because the player wasn't in the current camera
+         */
+        [[nodiscard]] size_t getThrottledCount() const { return throttledCount_; }
+
+    private:
+        void onPlayerLeaveRoom(const NetworkEvent::PlayerLeaveRoom& event);
+        void onPlayerEnterCamera(const NetworkEvent::PlayerEnterCamera& event);
+        void onPlayerLeaveCamera(const NetworkEvent::PlayerLeaveCamera& event);
+        void onPlayerPosition(const NetworkEvent::PlayerPosition& event);
+
+        void addDetailed(PlayerID player);
+        void removeDetailed(PlayerID player);
+
+    private:
+        static constexpr uint16_t NOT_DETAILED = std::numeric_limits<uint16_t>::max();
+
+        INetwork& network_;
+        PlayerRegistry& players_;
+
+        uint32_t camera_ = 0;                               //< Hash of current camera name
+        std::array<std::vector<PlayerID>, 2> detailed_;     //< Front and back detailed sets
+        size_t front_ = 0;
+        std::vector<uint16_t> detailedIndex_;               //< Player slot to index in front set
+
+        std::vector<NetworkEventBus::Subscription> subscriptions_;
+        size_t throttledCount_ = 0;
+    };
+}
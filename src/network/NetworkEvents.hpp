@@ -0,0 +1,226 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <tuple>
+
+#include <components/EventBus.hpp>
+#include <player/PlayerRegistry.hpp>
+
+namespace lpm
+{
+    /**
+     * @brief Events raised by INetwork implementations.
+     *
+     * Text and lists are only valid while the event is being dispatched. Handlers that need them later must copy them.
+     */
+    namespace NetworkEvent
+    {
+        //
+        // Connection
+        // ~=======================================================================================
+        struct Connected
+        {
+            static constexpr const char* NAME = "Connected";
+            static constexpr auto fields() { return std::tuple{}; }
+        };
+
+        struct Disconnected
+        {
+            static constexpr const char* NAME = "Disconnected";
+            static constexpr auto fields() { return std::tuple{}; }
+        };
+
+        struct ConnectionError
+        {
+            std::string_view reason;
+            static constexpr const char* NAME = "ConnectionError";
+            static constexpr auto fields() { return std::tuple{&ConnectionError::reason}; }
+        };
+
+        struct ConnectionKicked
+        {
+            std::string_view reason;
+            static constexpr const char* NAME = "ConnectionKicked";
+            static constexpr auto fields() { return std::tuple{&ConnectionKicked::reason}; }
+        };
+
+        /**
+         * Answer to INetwork::sendPing
+         */
+        struct Pong
+        {
+            uint32_t sequence = 0;
+            static constexpr const char* NAME = "Pong";
+            static constexpr auto fields() { return std::tuple{&Pong::sequence}; }
+        };
+
+        struct LoginStatus
+        {
+            bool success = false;
+            static constexpr const char* NAME = "LoginStatus";
+            static constexpr auto fields() { return std::tuple{&LoginStatus::success}; }
+        };
+
+        /**
+         * Answer to INetwork::changeRoom
+         */
+        struct RoomChanged
+        {
+            std::string_view room;
+            bool accepted = false;
+            static constexpr const char* NAME = "RoomChanged";
+            static constexpr auto fields() { return std::tuple{&RoomChanged::room, &RoomChanged::accepted}; }
+        };
+
+        //
+        // Players
+        // ~=======================================================================================
+        struct PlayerEnterRoom
+        {
+            PlayerID player;
+            std::string_view name;
+            static constexpr const char* NAME = "PlayerEnterRoom";
+            static constexpr auto fields() { return std::tuple{&PlayerEnterRoom::player, &PlayerEnterRoom::name}; }
+        };
+
+        struct PlayerLeaveRoom
+        {
+            PlayerID player;
+            static constexpr const char* NAME = "PlayerLeaveRoom";
+            static constexpr auto fields() { return std::tuple{&PlayerLeaveRoom::player}; }
+        };
+
+        struct PlayerEnterCamera
+        {
+            PlayerID player;
+            std::string_view camera;
+            static constexpr const char* NAME = "PlayerEnterCamera";
+            static constexpr auto fields() { return std::tuple{&PlayerEnterCamera::player, &PlayerEnterCamera::camera}; }
+        };
+
+        struct PlayerLeaveCamera
+        {
+            PlayerID player;
+            std::string_view camera;
+            static constexpr const char* NAME = "PlayerLeaveCamera";
+            static constexpr auto fields() { return std::tuple{&PlayerLeaveCamera::player, &PlayerLeaveCamera::camera}; }
+        };
+
+        struct PlayerRenamed
+        {
+            PlayerID player;
+            std::string_view name;
+            static constexpr const char* NAME = "PlayerRenamed";
+            static constexpr auto fields() { return std::tuple{&PlayerRenamed::player, &PlayerRenamed::name}; }
+        };
+
+        struct PlayerPosition
+        {
+            PlayerID player;
+            unsigned posX  = 0;
+            unsigned posY  = 0;
+            static constexpr const char* NAME = "PlayerPosition";
+            static constexpr auto fields() { return std::tuple{&PlayerPosition::player, &PlayerPosition::posX, &PlayerPosition::posY}; }
+        };
+
+        //
+        // Chat
+        // ~=======================================================================================
+        struct GlobalMessage
+        {
+            std::string_view message;
+            static constexpr const char* NAME = "GlobalMessage";
+            static constexpr auto fields() { return std::tuple{&GlobalMessage::message}; }
+        };
+
+        struct PlayerMessage
+        {
+            PlayerID player;
+            std::string_view message;
+            static constexpr const char* NAME = "PlayerMessage";
+            static constexpr auto fields() { return std::tuple{&PlayerMessage::player, &PlayerMessage::message}; }
+        };
+
+        struct PrivateMessage
+        {
+            PlayerID player;
+            std::string_view message;
+            static constexpr const char* NAME = "PrivateMessage";
+            static constexpr auto fields() { return std::tuple{&PrivateMessage::player, &PrivateMessage::message}; }
+        };
+
+        //
+        // Room
+        // ~=======================================================================================
+        struct RoomMessage
+        {
+            std::string_view message;
+            static constexpr const char* NAME = "RoomMessage";
+            static constexpr auto fields() { return std::tuple{&RoomMessage::message}; }
+        };
+
+        struct SpawnItem
+        {
+            uint32_t item = 0;          //< Server id of the item
+            std::string_view name;
+            unsigned posX = 0;
+            unsigned posY = 0;
+            static constexpr const char* NAME = "SpawnItem";
+            static constexpr auto fields() { return std::tuple{&SpawnItem::item, &SpawnItem::name, &SpawnItem::posX, &SpawnItem::posY}; }
+        };
+
+        struct DestroyItem
+        {
+            uint32_t item = 0;
+            static constexpr const char* NAME = "DestroyItem";
+            static constexpr auto fields() { return std::tuple{&DestroyItem::item}; }
+        };
+    }
+
+    /**
+     * Bus carrying every NetworkEvent. Don't reorder this list, the index of each event is its wire type id.
+     */
+    using NetworkEventBus = EventBus<
+        NetworkEvent::Connected,
+        NetworkEvent::Disconnected,
+        NetworkEvent::ConnectionError,
+        NetworkEvent::ConnectionKicked,
+        NetworkEvent::LoginStatus,
+        NetworkEvent::RoomChanged,
+        NetworkEvent::PlayerEnterRoom,
+        NetworkEvent::PlayerLeaveRoom,
+        NetworkEvent::PlayerEnterCamera,
+        NetworkEvent::PlayerLeaveCamera,
+        NetworkEvent::PlayerRenamed,
+        NetworkEvent::PlayerPosition,
+        NetworkEvent::GlobalMessage,
+        NetworkEvent::PlayerMessage,
+        NetworkEvent::PrivateMessage,
+        NetworkEvent::RoomMessage,
+        NetworkEvent::SpawnItem,
+        NetworkEvent::DestroyItem,
+        NetworkEvent::Pong
+    >;
+}
@@ -0,0 +1,200 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <exception>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <network/NetworkEvents.hpp>
+
+namespace lpm
+{
+    class network_log_exception final : public std::exception { };
+
+    /**
+     * @brief Binary format of recorded network sessions.
+     *
+     * File starts with a Header followed by one record per event:
+     * - varint: microseconds since previous record
+     * - uint8:  event type index in NetworkEventBus
+     * - event fields in NetworkEvent::fields() order
+     *
+     * Fields are encoded as: bool as one byte, unsigned integers as varint (LEB128), strings as varint length plus
+     * bytes and PlayerID as varint server id (0 for an invalid player).
+     */
+    namespace NetworkLog
+    {
+        static constexpr uint32_t MAGIC   = 0x524D504C; // "LPMR"
+        static constexpr uint16_t VERSION = 4;
+
+        struct Header
+        {
+            uint32_t magic;
+            uint16_t version;
+            uint16_t eventTypes;
+        };
+
+        class Writer
+        {
+        public:
+            explicit Writer(std::vector<uint8_t>& buffer, const PlayerRegistry& players)
+            : buffer_(buffer)
+            , players_(players)
+            {
+            }
+
+            void writeVarint(uint64_t value)
+            {
+                while(value >= 0x80)
+                {
+                    buffer_.push_back(static_cast<uint8_t>(value | 0x80));
+                    value >>= 7;
+                }
+                buffer_.push_back(static_cast<uint8_t>(value));
+            }
+
+            template<typename Event>
+            void writeEvent(const Event& event)
+            {
+                std::apply([&](auto... members){ (writeField(event.*members), ...); }, Event::fields());
+            }
+
+        private:
+            template<typename Field>
+            void writeField(const Field& field)
+            {
+                if constexpr(std::is_same_v<Field, bool>)
+                {
+                    buffer_.push_back(field ? 1 : 0);
+                }
+                else if constexpr(std::is_unsigned_v<Field>)
+                {
+                    writeVarint(field);
+                }
+                else if constexpr(std::is_same_v<Field, std::string_view>)
+                {
+                    writeVarint(field.size());
+                    buffer_.insert(buffer_.end(), field.begin(), field.end());
+                }
+                else if constexpr(std::is_same_v<Field, PlayerID>)
+                {
+                    writeVarint(players_.isValid(field) ? players_.getPlayer(field).getServerID() : 0);
+                }
+                else
+                {
+                    static_assert(sizeof(Field) == 0, "NetworkLog can't write this field type");
+                }
+            }
+
+        private:
+            std::vector<uint8_t>& buffer_;
+            const PlayerRegistry& players_;
+        };
+
+        class Reader
+        {
+        public:
+            explicit Reader(std::span<const uint8_t> data)
+            : data_(data)
+            {
+            }
+
+            [[nodiscard]] bool isValid() const { return bValid_; }
+            [[nodiscard]] bool isAtEnd() const { return offset_ >= data_.size(); }
+            [[nodiscard]] size_t getOffset() const { return offset_; }
+            void seek(size_t offset) { offset_ = offset; bValid_ = true; }
+
+            uint64_t readVarint()
+            {
+                uint64_t value = 0;
+                for(unsigned shift = 0; shift < 64; shift += 7)
+                {
+                    if(isAtEnd()) { bValid_ = false; return 0; }
+
+                    const uint8_t byte = data_[offset_++];
+                    value |= uint64_t(byte & 0x7F) << shift;
+                    if(!(byte & 0x80)) return value;
+                }
+                bValid_ = false;
+                return 0;
+            }
+
+            uint8_t readByte()
+            {
+                if(isAtEnd()) { bValid_ = false; return 0; }
+                return data_[offset_++];
+            }
+
+            /**
+             * Read fields of an event. Reader only decodes server ids, resolve turns each of them into a PlayerID.
+             */
+            template<typename Event, typename Resolve>
+            Event readEvent(Resolve&& resolve)
+            {
+                Event event {};
+                std::apply([&](auto... members){ (readField(event.*members, resolve), ...); }, Event::fields());
+                return event;
+            }
+
+        private:
+            template<typename Field, typename Resolve>
+            void readField(Field& field, Resolve& resolve)
+            {
+                if constexpr(std::is_same_v<Field, bool>)
+                {
+                    field = readByte() != 0;
+                }
+                else if constexpr(std::is_unsigned_v<Field>)
+                {
+                    field = static_cast<Field>(readVarint());
+                }
+                else if constexpr(std::is_same_v<Field, std::string_view>)
+                {
+                    const auto size = readVarint();
+                    if(size > data_.size() - offset_) { bValid_ = false; return; }
+
+                    field = { reinterpret_cast<const char*>(data_.data() + offset_), size };
+                    offset_ += size;
+                }
+                else if constexpr(std::is_same_v<Field, PlayerID>)
+                {
+                    const auto serverId = readVarint();
+                    field = bValid_ && serverId != 0 ? resolve(serverId) : PlayerID{};
+                }
+                else
+                {
+                    static_assert(sizeof(Field) == 0, "NetworkLog can't read this field type");
+                }
+            }
+
+        private:
+            std::span<const uint8_t> data_;
+            size_t offset_ = 0;
+            bool bValid_   = true;
+        };
+    }
+}
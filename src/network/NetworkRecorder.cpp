@@ -0,0 +1,84 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "NetworkRecorder.hpp"
+
+#include <network/INetwork.hpp>
+#include <network/NetworkLog.hpp>
+
+using namespace lpm;
+
+NetworkRecorder::NetworkRecorder(INetwork& network, std::string_view fileName)
+: network_(network)
+, file_(std::string(fileName), std::ios::binary | std::ios::trunc)
+, lastRecord_(Clock::now())
+{
+    if(!file_)
+    {
+        throw network_log_exception();
+    }
+
+    const NetworkLog::Header header { NetworkLog::MAGIC, NetworkLog::VERSION, NetworkEventBus::typeCount() };
+    file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    pending_.reserve(64 * 1024);
+    writing_.reserve(64 * 1024);
+    network_.getEvents().setPublishHook(NetworkEventBus::PublishHook::bind<&NetworkRecorder::onPublish>(this));
+}
+
+NetworkRecorder::~NetworkRecorder()
+{
+    network_.getEvents().setPublishHook({});
+    tick();
+    file_.flush();
+}
+
+void NetworkRecorder::tick()
+{
+    {
+        std::scoped_lock lock(mutex_);
+        std::swap(pending_, writing_);
+    }
+
+    file_.write(reinterpret_cast<const char*>(writing_.data()), static_cast<std::streamsize>(writing_.size()));
+    writing_.clear();
+}
+
+void NetworkRecorder::onPublish(uint32_t type, const void* event)
+{
+    // Pongs answer pings of this session, they mean nothing when replayed
+    if(type == NetworkEventBus::typeIndex<NetworkEvent::Pong>()) return;
+
+    const auto now = Clock::now();
+    const auto delta = std::chrono::duration_cast<std::chrono::microseconds>(now - lastRecord_).count();
+    lastRecord_ = now;
+
+    std::scoped_lock lock(mutex_);
+    NetworkLog::Writer writer(pending_, network_.getPlayers());
+    writer.writeVarint(static_cast<uint64_t>(delta));
+    pending_.push_back(static_cast<uint8_t>(type));
+
+    NetworkEventBus::visit(type, event, [&](const auto& typedEvent){
+        writer.writeEvent(typedEvent);
+    });
+
+    ++recordedCount_;
+}
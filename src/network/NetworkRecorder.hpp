@@ -0,0 +1,76 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace lpm
+{
+    class INetwork;
+
+    /**
+     * @brief Write every event published by a network into a NetworkLog file.
+     *
+     * Events are captured when they're published, with their timestamp, so the log has the real arrival pattern
+     * of the traffic. ReplayNetwork plays it back. Publishing only encodes into memory, tick() writes it to disk.
+     */
+    class NetworkRecorder
+    {
+    public:
+        /**
+         * Start recording
+         * @throw network_log_exception if file can't be created
+         */
+        NetworkRecorder(INetwork& network, std::string_view fileName);
+        ~NetworkRecorder();
+
+        NetworkRecorder(const NetworkRecorder&) = delete;
+        NetworkRecorder& operator=(const NetworkRecorder&) = delete;
+
+    public:
+        /**
+         * Write records captured since last tick into the file
+         */
+        void tick();
+
+        [[nodiscard]] size_t getRecordedCount() const { return recordedCount_; }
+
+    private:
+        void onPublish(uint32_t type, const void* event);
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        INetwork& network_;
+        std::ofstream file_;
+        std::mutex mutex_;
+        std::vector<uint8_t> pending_;  //< Records waiting for tick, guarded by mutex_
+        std::vector<uint8_t> writing_;  //< Records being written by tick
+        Clock::time_point lastRecord_;
+        size_t recordedCount_ = 0;
+    };
+}
@@ -0,0 +1,376 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "NetworkTelemetry.hpp"
+
+#include <algorithm>
+#include <fstream>
+
+#include <imgui.h>
+#include <nlohmann/json.hpp>
+
+#include <Configuration.hpp>
+#include <network/INetwork.hpp>
+
+using namespace lpm;
+
+namespace
+{
+    constexpr size_t LANE_COUNT = static_cast<size_t>(OutgoingQueue::ELane::Count);
+    constexpr const char* LANE_NAMES[LANE_COUNT] = { "Control", "Realtime", "Bulk" };
+
+    const char* eventName(uint32_t type)
+    {
+        const char* name = "Unknown";
+        NetworkEventBus::visitType(type, [&]<typename Event>(std::type_identity<Event>){ name = Event::NAME; });
+        return name;
+    }
+
+    float milliseconds(NetworkTelemetry::Clock::duration duration)
+    {
+        return std::chrono::duration<float, std::milli>(duration).count();
+    }
+}
+
+NetworkTelemetry::NetworkTelemetry(INetwork& network)
+: network_(network)
+{
+    // Timing every handler isn't free, only do it when the session is dumped. Debug builds toggle it from ImGui.
+    auto& events = network_.getEvents();
+    events.setProfiling(Configuration::NETWORK_TELEMETRY_FILE != nullptr);
+    pongSubscription_ = events.subscribe<NetworkEvent::Pong>(NetworkEventBus::Handler<NetworkEvent::Pong>::bind<&NetworkTelemetry::onPong>(this));
+}
+
+NetworkTelemetry::~NetworkTelemetry()
+{
+    network_.getEvents().unsubscribe(pongSubscription_);
+}
+
+void NetworkTelemetry::tick(float deltaTime, Clock::duration updateTime, Clock::duration dispatchTime)
+{
+    uptime_ += deltaTime;
+
+    const size_t queueDepth = network_.getEvents().getLastDispatchCount();
+    windowMaxQueueDepth_ = std::max(windowMaxQueueDepth_, queueDepth);
+    maxQueueDepth_ = std::max(maxQueueDepth_, queueDepth);
+    windowUpdateTime_ += updateTime;
+    windowDispatchTime_ += dispatchTime;
+    windowFrames_++;
+
+    pingTime_ += deltaTime;
+    if(pingTime_ >= PING_INTERVAL)
+    {
+        pingTime_ = 0.f;
+        expirePings();
+        sendPing();
+    }
+
+    windowTime_ += deltaTime;
+    if(windowTime_ >= SAMPLE_INTERVAL)
+    {
+        sample();
+    }
+}
+
+void NetworkTelemetry::reset()
+{
+    const auto& events = network_.getEvents();
+    for(uint32_t type = 0; type < EVENT_TYPES; type++)
+    {
+        lastStats_[type] = events.getStats(type);
+    }
+
+    rates_ = {};
+    messageHistory_ = {};
+    queueHistory_ = {};
+    rttHistory_ = {};
+    rtt_ = {};
+    coalesced_ = lastCoalesced_ = 0;
+    maxQueueDepth_ = 0;
+    uptime_ = 0.f;
+}
+
+//~====================================================================================================================
+// Ping
+
+void NetworkTelemetry::sendPing()
+{
+    // Reuse a free slot, or the oldest one when every ping is still in flight
+    auto slot = std::ranges::min_element(pings_, [](const PendingPing& a, const PendingPing& b){
+        if((a.sequence == 0) != (b.sequence == 0)) return a.sequence == 0;
+        return a.sent < b.sent;
+    });
+    if(slot->sequence != 0) rtt_.lost++;
+
+    slot->sequence = nextPing_++;
+    slot->sent = Clock::now();
+    network_.sendPing(slot->sequence);
+}
+
+void NetworkTelemetry::onPong(const NetworkEvent::Pong& event)
+{
+    const auto ping = std::ranges::find(pings_, event.sequence, &PendingPing::sequence);
+    if(event.sequence == 0 || ping == pings_.end()) return;
+
+    const float rtt = milliseconds(Clock::now() - ping->sent);
+    ping->sequence = 0;
+
+    rtt_.last = rtt;
+    rtt_.min = rtt_.samples ? std::min(rtt_.min, rtt) : rtt;
+    rtt_.max = rtt_.samples ? std::max(rtt_.max, rtt) : rtt;
+    rtt_.average += (rtt - rtt_.average) / static_cast<float>(++rtt_.samples);
+
+    size_t bucket = 0;
+    while(bucket + 1 < RTT_BUCKETS && rtt >= static_cast<float>(1u << bucket)) bucket++;
+    rtt_.histogram[bucket]++;
+}
+
+void NetworkTelemetry::expirePings()
+{
+    const auto now = Clock::now();
+    for(auto& ping : pings_)
+    {
+        if(ping.sequence != 0 && std::chrono::duration<float>(now - ping.sent).count() > PING_TIMEOUT)
+        {
+            ping.sequence = 0;
+            rtt_.lost++;
+        }
+    }
+}
+
+//~====================================================================================================================
+// Sampling
+
+void NetworkTelemetry::sample()
+{
+    const auto& events = network_.getEvents();
+
+    messageRate_ = 0.f;
+    byteRate_ = 0.f;
+    for(uint32_t type = 0; type < EVENT_TYPES; type++)
+    {
+        const auto stats = events.getStats(type);
+        const auto& last = lastStats_[type];
+        const auto published = stats.published - last.published;
+
+        auto& rates = rates_[type];
+        rates.messages = static_cast<float>(published) / windowTime_;
+        rates.bytes    = static_cast<float>(stats.bytes - last.bytes) / windowTime_;
+        rates.dropped  = static_cast<float>(stats.dropped - last.dropped) / windowTime_;
+        rates.dispatchMicroseconds = published ? static_cast<float>(stats.dispatchNanoseconds - last.dispatchNanoseconds) / 1000.f / static_cast<float>(published) : 0.f;
+
+        const auto decoded = stats.decoded - last.decoded;
+        rates.decodeMicroseconds = decoded ? static_cast<float>(stats.decodeNanoseconds - last.decodeNanoseconds) / 1000.f / static_cast<float>(decoded) : 0.f;
+
+        messageRate_ += rates.messages;
+        byteRate_ += rates.bytes;
+        lastStats_[type] = stats;
+    }
+
+    coalescedRate_ = static_cast<float>(coalesced_ - lastCoalesced_) / windowTime_;
+    lastCoalesced_ = coalesced_;
+
+    const auto frames = static_cast<float>(std::max<size_t>(windowFrames_, 1));
+    updateMilliseconds_ = milliseconds(windowUpdateTime_) / frames;
+    dispatchMilliseconds_ = milliseconds(windowDispatchTime_) / frames;
+    queueDepth_ = windowMaxQueueDepth_;
+
+    messageHistory_[historyOffset_] = messageRate_;
+    queueHistory_[historyOffset_] = static_cast<float>(queueDepth_);
+    rttHistory_[historyOffset_] = rtt_.last;
+    historyOffset_ = (historyOffset_ + 1) % HISTORY_SIZE;
+
+    windowTime_ = 0.f;
+    windowFrames_ = 0;
+    windowMaxQueueDepth_ = 0;
+    windowUpdateTime_ = {};
+    windowDispatchTime_ = {};
+}
+
+//~====================================================================================================================
+// Output
+
+nlohmann::json NetworkTelemetry::toJson() const
+{
+    const auto& bus = network_.getEvents();
+
+    nlohmann::json json;
+    json["uptime"] = uptime_;
+    json["messagesPerSecond"] = messageRate_;
+    json["bytesPerSecond"] = byteRate_;
+    json["updateMs"] = updateMilliseconds_;
+    json["dispatchMs"] = dispatchMilliseconds_;
+    json["queueDepth"] = queueDepth_;
+    json["maxQueueDepth"] = maxQueueDepth_;
+    json["dropped"] = bus.getDroppedCount();
+    json["coalesced"] = coalesced_;
+    json["coalescedPerSecond"] = coalescedRate_;
+
+    auto& events = json["events"];
+    events = nlohmann::json::array();
+    for(uint32_t type = 0; type < EVENT_TYPES; type++)
+    {
+        const auto stats = bus.getStats(type);
+        const auto& rates = rates_[type];
+        events.push_back({
+            { "name", eventName(type) },
+            { "published", stats.published },
+            { "dropped", stats.dropped },
+            { "decoded", stats.decoded },
+            { "bytes", stats.bytes },
+            { "messagesPerSecond", rates.messages },
+            { "bytesPerSecond", rates.bytes },
+            { "droppedPerSecond", rates.dropped },
+            { "dispatchUs", rates.dispatchMicroseconds },
+            { "decodeUs", rates.decodeMicroseconds }
+        });
+    }
+
+    auto& rtt = json["rtt"];
+    rtt["lastMs"] = rtt_.last;
+    rtt["minMs"] = rtt_.min;
+    rtt["maxMs"] = rtt_.max;
+    rtt["averageMs"] = rtt_.average;
+    rtt["samples"] = rtt_.samples;
+    rtt["lost"] = rtt_.lost;
+    auto& histogram = rtt["histogram"];
+    histogram = nlohmann::json::array();
+    for(size_t bucket = 0; bucket < RTT_BUCKETS; bucket++)
+    {
+        // Last bucket has no upper bound
+        const nlohmann::json upTo = bucket + 1 < RTT_BUCKETS ? nlohmann::json(1u << bucket) : nlohmann::json(nullptr);
+        histogram.push_back({ { "belowMs", upTo }, { "count", rtt_.histogram[bucket] } });
+    }
+
+    auto& outgoing = json["outgoing"];
+    outgoing = nlohmann::json::array();
+    for(size_t lane = 0; lane < LANE_COUNT; lane++)
+    {
+        const auto& stats = network_.getOutgoing().getLaneStats(static_cast<OutgoingQueue::ELane>(lane));
+        outgoing.push_back({
+            { "lane", LANE_NAMES[lane] },
+            { "queued", stats.queued },
+            { "sent", stats.sent },
+            { "coalesced", stats.coalesced },
+            { "rejected", stats.rejected },
+            { "dropped", stats.dropped }
+        });
+    }
+
+    return json;
+}
+
+bool NetworkTelemetry::dump(std::string_view fileName) const
+{
+    std::ofstream file{ std::string(fileName) };
+    if(!file) return false;
+
+    file << toJson().dump(4);
+    return static_cast<bool>(file);
+}
+
+void NetworkTelemetry::drawImGui()
+{
+    auto& events = network_.getEvents();
+
+    ImGui::Begin("Debug - Network");
+
+    ImGui::LabelText("Messages/s", "%.0f", static_cast<double>(messageRate_));
+    ImGui::LabelText("Bytes/s", "%.0f", static_cast<double>(byteRate_));
+    ImGui::LabelText("Update ms", "%.3f", static_cast<double>(updateMilliseconds_));
+    ImGui::LabelText("Dispatch ms", "%.3f", static_cast<double>(dispatchMilliseconds_));
+    ImGui::LabelText("Queue depth", "%u (max %u)", static_cast<unsigned>(queueDepth_), static_cast<unsigned>(maxQueueDepth_));
+    ImGui::LabelText("Dropped", "%u", static_cast<unsigned>(events.getDroppedCount()));
+    ImGui::LabelText("Coalesced/s", "%.0f", static_cast<double>(coalescedRate_));
+    ImGui::PlotLines("Messages/s", messageHistory_.data(), static_cast<int>(HISTORY_SIZE), static_cast<int>(historyOffset_));
+    ImGui::PlotLines("Queue depth", queueHistory_.data(), static_cast<int>(HISTORY_SIZE), static_cast<int>(historyOffset_));
+
+    if(ImGui::CollapsingHeader("Round trip"))
+    {
+        ImGui::LabelText("Last ms", "%.1f", static_cast<double>(rtt_.last));
+        ImGui::LabelText("Min/avg/max ms", "%.1f / %.1f / %.1f", static_cast<double>(rtt_.min), static_cast<double>(rtt_.average), static_cast<double>(rtt_.max));
+        ImGui::LabelText("Lost", "%u of %u", static_cast<unsigned>(rtt_.lost), static_cast<unsigned>(rtt_.lost + rtt_.samples));
+        ImGui::PlotLines("RTT ms", rttHistory_.data(), static_cast<int>(HISTORY_SIZE), static_cast<int>(historyOffset_));
+
+        std::array<float, RTT_BUCKETS> histogram {};
+        std::ranges::transform(rtt_.histogram, histogram.begin(), [](uint64_t count){ return static_cast<float>(count); });
+        ImGui::PlotHistogram("RTT < 2^n ms", histogram.data(), static_cast<int>(RTT_BUCKETS));
+    }
+
+    if(ImGui::CollapsingHeader("Events") && ImGui::BeginTable("events", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+    {
+        ImGui::TableSetupColumn("Event");
+        ImGui::TableSetupColumn("Msg/s");
+        ImGui::TableSetupColumn("Bytes/s");
+        ImGui::TableSetupColumn("Drop/s");
+        ImGui::TableSetupColumn("us/msg");
+        ImGui::TableSetupColumn("Decode us");
+        ImGui::TableHeadersRow();
+
+        for(uint32_t type = 0; type < EVENT_TYPES; type++)
+        {
+            const auto& rates = rates_[type];
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(eventName(type));
+            ImGui::TableNextColumn(); ImGui::Text("%.0f", static_cast<double>(rates.messages));
+            ImGui::TableNextColumn(); ImGui::Text("%.0f", static_cast<double>(rates.bytes));
+            ImGui::TableNextColumn(); ImGui::Text("%.0f", static_cast<double>(rates.dropped));
+            ImGui::TableNextColumn(); ImGui::Text("%.2f", static_cast<double>(rates.dispatchMicroseconds));
+            ImGui::TableNextColumn(); ImGui::Text("%.2f", static_cast<double>(rates.decodeMicroseconds));
+        }
+        ImGui::EndTable();
+    }
+
+    if(ImGui::CollapsingHeader("Outgoing") && ImGui::BeginTable("outgoing", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+    {
+        ImGui::TableSetupColumn("Lane");
+        ImGui::TableSetupColumn("Queued");
+        ImGui::TableSetupColumn("Sent");
+        ImGui::TableSetupColumn("Coalesced");
+        ImGui::TableSetupColumn("Rejected");
+        ImGui::TableSetupColumn("Dropped");
+        ImGui::TableHeadersRow();
+
+        for(size_t lane = 0; lane < LANE_COUNT; lane++)
+        {
+            const auto& stats = network_.getOutgoing().getLaneStats(static_cast<OutgoingQueue::ELane>(lane));
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(LANE_NAMES[lane]);
+            ImGui::TableNextColumn(); ImGui::Text("%u", static_cast<unsigned>(stats.queued));
+            ImGui::TableNextColumn(); ImGui::Text("%u", static_cast<unsigned>(stats.sent));
+            ImGui::TableNextColumn(); ImGui::Text("%u", static_cast<unsigned>(stats.coalesced));
+            ImGui::TableNextColumn(); ImGui::Text("%u", static_cast<unsigned>(stats.rejected));
+            ImGui::TableNextColumn(); ImGui::Text("%u", static_cast<unsigned>(stats.dropped));
+        }
+        ImGui::EndTable();
+    }
+
+    bool bProfiling = events.isProfiling();
+    if(ImGui::Checkbox("Profile handlers", &bProfiling)) events.setProfiling(bProfiling);
+
+    ImGui::SameLine();
+    if(ImGui::Button("Reset")) reset();
+
+    ImGui::SameLine();
+    if(ImGui::Button("Dump")) dump("network_telemetry.json");
+
+    ImGui::End();
+}
@@ -0,0 +1,169 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+#include <nlohmann/json_fwd.hpp>
+
+#include <network/NetworkEvents.hpp>
+
+namespace lpm
+{
+    class INetwork;
+
+    /**
+     * @brief Traffic counters of an INetwork.
+     *
+     * Collects, per event type, messages and bytes per second, decode and dispatch time and drops, plus inbound
+     * queue depth, total time spent in INetwork::update, coalesced updates, and round trip time measured with pings.
+     * Decode time is what implementations report when they publish an event they parsed.
+     * Rates are sampled every SAMPLE_INTERVAL seconds and the last HISTORY_SIZE samples are kept for plotting.
+     *
+     * Results are shown by drawImGui() and exported as JSON by toJson()/dump() to attach them to lag reports.
+     */
+    class NetworkTelemetry
+    {
+    public:
+        static constexpr float SAMPLE_INTERVAL = 1.f;
+        static constexpr size_t HISTORY_SIZE   = 60;
+        static constexpr float PING_INTERVAL   = 1.f;
+        static constexpr float PING_TIMEOUT    = 5.f;      //< Pings without answer after this are lost
+        static constexpr size_t RTT_BUCKETS    = 12;       //< Bucket i counts RTT below 2^i ms, last one the rest
+
+        static constexpr uint32_t EVENT_TYPES = NetworkEventBus::typeCount();
+
+        using Clock = std::chrono::steady_clock;
+
+        struct EventRates
+        {
+            float messages = 0.f;           //< Events per second
+            float bytes    = 0.f;           //< Queued bytes per second
+            float dropped  = 0.f;           //< Dropped events per second
+            float dispatchMicroseconds = 0.f;   //< Average handler time per event
+            float decodeMicroseconds = 0.f;     //< Average decode time per decoded event
+        };
+
+        struct RttStats
+        {
+            float last = 0.f;               //< Milliseconds
+            float min  = 0.f;
+            float max  = 0.f;
+            float average = 0.f;
+            uint64_t samples = 0;
+            uint64_t lost    = 0;
+            std::array<uint64_t, RTT_BUCKETS> histogram {};
+        };
+
+    public:
+        explicit NetworkTelemetry(INetwork& network);
+        ~NetworkTelemetry();
+
+        NetworkTelemetry(const NetworkTelemetry&) = delete;
+        NetworkTelemetry& operator=(const NetworkTelemetry&) = delete;
+
+    public:
+        /**
+         * Account one frame of the network. INetwork::tick calls it after dispatching.
+         * @param updateTime Time spent in INetwork::update
+         * @param dispatchTime Time spent dispatching events
+         */
+        void tick(float deltaTime, Clock::duration updateTime, Clock::duration dispatchTime);
+
+        /**
+         * Count updates merged or throttled before reaching their consumers
+         */
+        void addCoalesced(uint32_t count = 1) { coalesced_ += count; }
+
+        void reset();
+
+    public:
+        [[nodiscard]] const EventRates& getRates(uint32_t type) const { return rates_[type]; }
+        [[nodiscard]] const RttStats& getRtt() const { return rtt_; }
+        [[nodiscard]] uint64_t getCoalescedCount() const { return coalesced_; }
+        [[nodiscard]] size_t getMaxQueueDepth() const { return maxQueueDepth_; }
+
+        [[nodiscard]] nlohmann::json toJson() const;
+
+        /**
+         * Write toJson() into file
+         * @return False if file can't be written
+         */
+        bool dump(std::string_view fileName) const;
+
+        void drawImGui();
+
+    private:
+        void sendPing();
+        void onPong(const NetworkEvent::Pong& event);
+        void expirePings();
+        void sample();
+
+    private:
+        struct PendingPing
+        {
+            uint32_t sequence = 0;          //< 0 if slot is free
+            Clock::time_point sent;
+        };
+
+        INetwork& network_;
+        NetworkEventBus::Subscription pongSubscription_;
+
+        // Counters of the current sample window
+        std::array<NetworkEventBus::TypeStats, EVENT_TYPES> lastStats_ {};
+        uint64_t lastCoalesced_ = 0;
+        float windowTime_ = 0.f;
+        size_t windowFrames_ = 0;
+        size_t windowMaxQueueDepth_ = 0;
+        Clock::duration windowUpdateTime_ {};
+        Clock::duration windowDispatchTime_ {};
+
+        // Last sample
+        std::array<EventRates, EVENT_TYPES> rates_ {};
+        float messageRate_ = 0.f;           //< All events per second
+        float byteRate_ = 0.f;
+        float coalescedRate_ = 0.f;
+        float updateMilliseconds_ = 0.f;    //< Average per frame
+        float dispatchMilliseconds_ = 0.f;
+        size_t queueDepth_ = 0;             //< Largest frame of the sample
+
+        // History of samples, ring indexed by historyOffset_
+        std::array<float, HISTORY_SIZE> messageHistory_ {};
+        std::array<float, HISTORY_SIZE> queueHistory_ {};
+        std::array<float, HISTORY_SIZE> rttHistory_ {};
+        size_t historyOffset_ = 0;
+
+        // Totals
+        uint64_t coalesced_ = 0;
+        size_t maxQueueDepth_ = 0;
+        float uptime_ = 0.f;
+
+        // Ping
+        std::array<PendingPing, 8> pings_ {};
+        uint32_t nextPing_ = 1;
+        float pingTime_ = 0.f;
+        RttStats rtt_;
+    };
+}
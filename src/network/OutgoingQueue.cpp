@@ -0,0 +1,158 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "OutgoingQueue.hpp"
+
+#include <algorithm>
+
+using namespace lpm;
+
+void OutgoingMessage::setText(std::string_view value)
+{
+    length = static_cast<uint16_t>(std::min(value.size(), MAX_TEXT));
+    std::copy_n(value.data(), length, text.data());
+}
+
+size_t OutgoingMessage::getWireSize() const
+{
+    // Type, target or position, and the text
+    return sizeof(type) + sizeof(target) + length;
+}
+
+OutgoingQueue::OutgoingQueue()
+{
+    setLaneSettings(ELane::Control,  { 20.f, 20.f, 32, false });
+    setLaneSettings(ELane::Realtime, { 30.f, 5.f, 8, true });
+    setLaneSettings(ELane::Bulk,     { 4.f, 8.f, 64, false });
+}
+
+OutgoingQueue::EPushResult OutgoingQueue::push(const OutgoingMessage& message)
+{
+    auto& lane = lanes_[static_cast<size_t>(getLane(message.type))];
+
+    if(isCoalescable(message.type))
+    {
+        for(size_t i = 0; i < lane.stats.queued; i++)
+        {
+            if(auto& queued = lane.at(i); queued.type == message.type)
+            {
+                queued = message;
+                ++lane.stats.coalesced;
+                return EPushResult::Coalesced;
+            }
+        }
+    }
+
+    if(lane.stats.queued == lane.ring.size())
+    {
+        if(!lane.settings.bDropOldest)
+        {
+            ++lane.stats.rejected;
+            return EPushResult::Rejected;
+        }
+
+        lane.pop();
+        ++lane.stats.dropped;
+    }
+
+    lane.at(lane.stats.queued++) = message;
+    return EPushResult::Queued;
+}
+
+void OutgoingQueue::flush(float deltaTime, size_t backlog, Transmit transmit)
+{
+    for(size_t index = 0; index < lanes_.size(); index++)
+    {
+        auto& lane = lanes_[index];
+        lane.tokens = std::min(lane.tokens + lane.settings.rate * deltaTime, lane.settings.burst);
+
+        // A congested link keeps control traffic flowing and pauses the rest, lowest priority first
+        const auto type = static_cast<ELane>(index);
+        if(type == ELane::Bulk && backlog > SOFT_BACKLOG) continue;
+        if(type == ELane::Realtime && backlog > HARD_BACKLOG) continue;
+
+        while(lane.stats.queued > 0 && lane.tokens >= 1.f)
+        {
+            const auto& message = lane.at(0);
+            if(!transmit(message)) return;
+
+            backlog += message.getWireSize();
+            lane.tokens -= 1.f;
+            lane.pop();
+            ++lane.stats.sent;
+        }
+    }
+}
+
+void OutgoingQueue::clear()
+{
+    for(auto& lane : lanes_)
+    {
+        lane.head = 0;
+        lane.stats.queued = 0;
+    }
+}
+
+void OutgoingQueue::setLaneSettings(ELane lane, const LaneSettings& settings)
+{
+    auto& target = lanes_[static_cast<size_t>(lane)];
+    target.settings = settings;
+    target.settings.capacity = std::max<size_t>(settings.capacity, 1);
+    target.tokens = settings.burst;
+
+    // Resizing drops queued messages, lanes are only configured on start
+    target.ring.assign(target.settings.capacity, {});
+    target.head = 0;
+    target.stats.queued = 0;
+}
+
+OutgoingQueue::ELane OutgoingQueue::getLane(EOutgoing type)
+{
+    switch(type)
+    {
+        case EOutgoing::Position:       return ELane::Realtime;
+        case EOutgoing::Camera:
+        case EOutgoing::Room:
+        case EOutgoing::RoomSnapshot:
+        case EOutgoing::Ping:           return ELane::Control;
+        case EOutgoing::Chat:
+        case EOutgoing::PrivateChat:    return ELane::Bulk;
+    }
+    return ELane::Bulk;
+}
+
+bool OutgoingQueue::isCoalescable(EOutgoing type)
+{
+    switch(type)
+    {
+        case EOutgoing::Position:
+        case EOutgoing::Camera:
+        case EOutgoing::Room:
+        case EOutgoing::RoomSnapshot:   return true;
+        default:                        return false;
+    }
+}
+
+void OutgoingQueue::Lane::pop()
+{
+    head = (head + 1) % ring.size();
+    --stats.queued;
+}
@@ -0,0 +1,170 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include <Configuration.hpp>
+#include <components/Delegate.hpp>
+
+namespace lpm
+{
+    enum class EOutgoing : uint8_t
+    {
+        Position,           //< Cursor of local player
+        Camera,             //< Camera watched by local player
+        Room,               //< Room change request
+        RoomSnapshot,       //< Room member list request
+        Ping,
+        Chat,               //< Message to the room
+        PrivateChat         //< Message to a player
+    };
+
+    /**
+     * @brief Message waiting to be sent to server.
+     */
+    struct OutgoingMessage
+    {
+        static constexpr size_t MAX_TEXT = Configuration::MAX_CHAT_MESSAGE_LENGTH;
+
+        EOutgoing type = EOutgoing::Chat;
+        uint64_t target = 0;                //< Server id of receiver of PrivateChat
+        unsigned posX = 0;
+        unsigned posY = 0;
+        uint32_t sequence = 0;              //< Ping sequence
+        uint16_t length = 0;
+        std::array<char, MAX_TEXT> text {}; //< Chat message, camera or room name
+
+        void setText(std::string_view value);
+        [[nodiscard]] std::string_view getText() const { return { text.data(), length }; }
+
+        /**
+         * Approximate bytes used on the wire
+         */
+        [[nodiscard]] size_t getWireSize() const;
+    };
+
+    /**
+     * @brief Outgoing traffic split in priority lanes.
+     *
+     * Each lane has its own bounded ring and token bucket, and lanes are drained in priority order: control requests,
+     * then realtime state (cursor position), then bulk traffic (chat). A chat burst can only consume the chat budget,
+     * so it never delays cursor updates.
+     *
+     * Messages describing state (position, camera, room) replace a queued message of the same kind instead of being
+     * queued twice. When the transport reports a growing backlog, bulk lanes stop draining first and realtime ones
+     * later. Lanes never grow: when full, realtime drops its oldest message and the other lanes reject new ones.
+     */
+    class OutgoingQueue
+    {
+    public:
+        enum class ELane : uint8_t
+        {
+            Control,
+            Realtime,
+            Bulk,
+
+            Count
+        };
+
+        struct LaneSettings
+        {
+            float rate      = 10.f;         //< Messages per second
+            float burst     = 10.f;         //< Messages sent at once after being idle
+            size_t capacity = 32;           //< Messages queued before dropping or rejecting
+            bool bDropOldest = false;       //< When full drop oldest message instead of rejecting new one
+        };
+
+        struct LaneStats
+        {
+            size_t queued = 0;              //< Waiting now
+            uint64_t sent = 0;
+            uint64_t coalesced = 0;         //< Replaced by a newer message before being sent
+            uint64_t rejected = 0;          //< Refused because lane was full
+            uint64_t dropped = 0;           //< Discarded by a newer message because lane was full
+        };
+
+        enum class EPushResult : uint8_t
+        {
+            Queued,
+            Coalesced,
+            Rejected
+        };
+
+        static constexpr size_t SOFT_BACKLOG = 16 * 1024;      //< Transport bytes pending before bulk lanes pause
+        static constexpr size_t HARD_BACKLOG = 64 * 1024;      //< Transport bytes pending before realtime lanes pause
+
+        /**
+         * Send message through transport
+         * @return False if transport can't take it now, message stays queued
+         */
+        using Transmit = Delegate<bool(const OutgoingMessage&)>;
+
+    public:
+        OutgoingQueue();
+
+    public:
+        EPushResult push(const OutgoingMessage& message);
+
+        /**
+         * Send queued messages allowed by rate limits and backlog
+         * @param backlog Bytes queued by transport and not sent yet
+         */
+        void flush(float deltaTime, size_t backlog, Transmit transmit);
+
+        /**
+         * Discard every queued message
+         */
+        void clear();
+
+        void setLaneSettings(ELane lane, const LaneSettings& settings);
+
+    public:
+        [[nodiscard]] static ELane getLane(EOutgoing type);
+        [[nodiscard]] const LaneSettings& getLaneSettings(ELane lane) const { return lanes_[static_cast<size_t>(lane)].settings; }
+        [[nodiscard]] const LaneStats& getLaneStats(ELane lane) const { return lanes_[static_cast<size_t>(lane)].stats; }
+
+    private:
+        struct Lane
+        {
+            LaneSettings settings;
+            LaneStats stats;
+            std::vector<OutgoingMessage> ring;
+            size_t head = 0;
+            float tokens = 0.f;
+
+            [[nodiscard]] OutgoingMessage& at(size_t position) { return ring[(head + position) % ring.size()]; }
+            void pop();
+        };
+
+        /**
+         * Messages describing state are superseded by newer ones of the same type
+         */
+        [[nodiscard]] static bool isCoalescable(EOutgoing type);
+
+    private:
+        std::array<Lane, static_cast<size_t>(ELane::Count)> lanes_;
+    };
+}
@@ -0,0 +1,190 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "ReplayNetwork.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+
+#include <network/NetworkLog.hpp>
+
+using namespace lpm;
+
+ReplayNetwork::ReplayNetwork(std::string_view fileName, float speed, bool bLoop)
+: speed_(speed)
+, bLoop_(bLoop)
+{
+    std::ifstream file(std::string(fileName), std::ios::binary);
+    if(!file)
+    {
+        throw network_log_exception();
+    }
+    data_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    NetworkLog::Header header {};
+    if(data_.size() < sizeof(header))
+    {
+        throw network_log_exception();
+    }
+
+    std::memcpy(&header, data_.data(), sizeof(header));
+    if(header.magic != NetworkLog::MAGIC || header.version != NetworkLog::VERSION || header.eventTypes != NetworkEventBus::typeCount())
+    {
+        throw network_log_exception();
+    }
+
+    rewind();
+}
+
+void ReplayNetwork::init()
+{
+    rewind();
+}
+
+void ReplayNetwork::update(float deltaTime)
+{
+    time_ = speed_ > 0 ? time_ + double(deltaTime) * speed_ * 1e6 : std::numeric_limits<double>::infinity();
+
+    while(true)
+    {
+        if(isFinished())
+        {
+            if(!bLoop_ || data_.size() <= sizeof(NetworkLog::Header)) return;
+            rewind();
+        }
+
+        size_t offset = offset_;
+        if(!publishRecord(offset)) return;
+        offset_ = offset;
+    }
+}
+
+bool ReplayNetwork::publishRecord(size_t& offset)
+{
+    NetworkLog::Reader reader(data_);
+    reader.seek(offset);
+
+    const double recordTime = recordTime_ + static_cast<double>(reader.readVarint());
+    if(recordTime > time_) return false;
+
+    const uint8_t type = reader.readByte();
+
+    bool bPublished = false;
+    const bool bKnownType = NetworkEventBus::visitType(type, [&](auto identity){
+        using Event = typename decltype(identity)::type;
+
+        // Mimic what a live network does with the registry: players are only created when they enter
+        PlayerID added;
+        PlayerID revived;
+        const auto decodeStart = std::chrono::steady_clock::now();
+        const auto event = reader.readEvent<Event>([&](uint64_t serverId){
+            if constexpr(std::is_same_v<Event, NetworkEvent::PlayerEnterRoom>)
+            {
+                const auto existing = players_.find(serverId);
+                if(existing.isValid() && players_.isPendingRemoval(existing)) revived = existing;
+
+                const auto player = players_.add(serverId, {});
+                if(!existing.isValid()) added = player;
+                return player;
+            }
+            else
+            {
+                return players_.find(serverId);
+            }
+        });
+        const auto decodeTime = std::chrono::steady_clock::now() - decodeStart;
+
+        // Record may be read again next frame, leave the registry as it was
+        auto undo = [&]{
+            if(added.isValid()) players_.remove(added);
+            if(revived.isValid()) players_.removeLater(revived);
+        };
+
+        if(!reader.isValid())
+        {
+            undo();
+            return;
+        }
+
+        // Recorded answers belong to requests of the recorded client, transmit answers ours
+        if constexpr(std::is_same_v<Event, NetworkEvent::RoomChanged>)
+        {
+            bPublished = true;
+            return;
+        }
+
+        bPublished = events_.publish(event, decodeTime);
+        if(!bPublished)
+        {
+            undo();
+            return;
+        }
+
+        if constexpr(std::is_same_v<Event, NetworkEvent::PlayerEnterRoom> || std::is_same_v<Event, NetworkEvent::PlayerRenamed>)
+        {
+            players_.rename(event.player, event.name);
+        }
+        else if constexpr(std::is_same_v<Event, NetworkEvent::PlayerLeaveRoom>)
+        {
+            players_.removeLater(event.player);
+        }
+    });
+
+    if(!bKnownType || !reader.isValid())
+    {
+        // Corrupted log, stop playback
+        offset  = data_.size();
+        offset_ = data_.size();
+        bLoop_  = false;
+        return false;
+    }
+
+    if(!bPublished) return false;
+
+    recordTime_ = recordTime;
+    offset = reader.getOffset();
+    return true;
+}
+
+bool ReplayNetwork::isFinished() const
+{
+    return offset_ >= data_.size();
+}
+
+void ReplayNetwork::rewind()
+{
+    offset_     = sizeof(NetworkLog::Header);
+    time_       = 0;
+    recordTime_ = 0;
+}
+
+bool ReplayNetwork::transmit(const OutgoingMessage& message)
+{
+    // There is no server behind a replay, accept every room change so the client can move around
+    if(message.type == EOutgoing::Room)
+    {
+        return events_.publish(NetworkEvent::RoomChanged{ message.getText(), true });
+    }
+    return true;
+}
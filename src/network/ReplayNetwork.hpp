@@ -0,0 +1,81 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include <network/INetwork.hpp>
+
+namespace lpm
+{
+    /**
+     * @brief Network that plays back a session recorded by NetworkRecorder.
+     *
+     * Events are published with their recorded timing scaled by speed, through the same bus real traffic uses.
+     * If the bus is full, remaining events wait for the next frame instead of being dropped, so every run of the
+     * same log delivers the same events in the same order. Outgoing traffic is ignored, except room changes which are
+     * always accepted. Recorded RoomChanged events are skipped, they answered requests of the recorded client.
+     */
+    class ReplayNetwork : public INetwork
+    {
+    public:
+        /**
+         * Load log
+         * @param speed Playback speed, 1 is real time. 0 or negative delivers events as fast as the bus accepts them.
+         * @param bLoop Restart when the log ends
+         * @throw network_log_exception if file can't be read or isn't a network log
+         */
+        explicit ReplayNetwork(std::string_view fileName, float speed = 1.f, bool bLoop = false);
+
+    public:
+        void init() override;
+        void update(float deltaTime) override;
+
+    public:
+        void setSpeed(float speed) { speed_ = speed; }
+        [[nodiscard]] bool isFinished() const;
+
+    protected:
+        bool transmit(const OutgoingMessage& message) override;
+
+    private:
+        void rewind();
+
+        /**
+         * Publish next record
+         * @return False if bus is full or log ended
+         */
+        bool publishRecord(size_t& offset);
+
+    private:
+        std::vector<uint8_t> data_;
+
+        size_t offset_ = 0;                 //< Next record
+        double time_ = 0;                   //< Playback time in microseconds
+        double recordTime_ = 0;             //< Time of last published record in microseconds
+
+        float speed_;
+        bool bLoop_;
+    };
+}
@@ -0,0 +1,238 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "RoomMembership.hpp"
+
+#include <algorithm>
+
+#include <network/INetwork.hpp>
+
+using namespace lpm;
+
+RoomMembership::RoomMembership(INetwork& network)
+: network_(network)
+{
+    buffered_.reserve(MAX_BUFFERED);
+}
+
+void RoomMembership::applyDelta(const Delta& delta)
+{
+    if(bAwaitingSnapshot_)
+    {
+        buffer(delta);
+        return;
+    }
+
+    if(delta.version <= version_)
+    {
+        ++staleCount_;
+        return;
+    }
+
+    if(delta.version != version_ + 1)
+    {
+        ++gapCount_;
+        buffer(delta);
+        requestSnapshot();
+        return;
+    }
+
+    version_ = delta.version;
+    if(!apply(delta)) requestSnapshot();
+}
+
+void RoomMembership::applySnapshot(uint32_t version, std::span<const Member> members)
+{
+    auto& players = network_.getPlayers();
+
+    // Players added below go after the current ones, so only [0, previous) has to be checked for leaving
+    const size_t previous = players.size();
+    keep_.assign(previous, 0);
+
+    bool bSynchronized = true;
+    for(const auto& member : members)
+    {
+        const auto player = players.find(member.serverId);
+        if(player.isValid())
+        {
+            const auto dense = players.getDenseIndex(player);
+            if(dense < previous) keep_[dense] = 1;
+        }
+
+        if(player.isValid() && !players.isPendingRemoval(player))
+        {
+            if(players.getPlayer(player).getName() != member.name) bSynchronized &= rename(member.serverId, member.name);
+        }
+        else
+        {
+            bSynchronized &= enter(member.serverId, member.name);
+        }
+    }
+
+    for(size_t dense = 0; dense < previous; dense++)
+    {
+        if(!keep_[dense]) bSynchronized &= leave(players.getPlayer(players.getPlayerAt(dense)).getServerID());
+    }
+
+    ++snapshotCount_;
+    version_ = version;
+    bAwaitingSnapshot_ = false;
+
+    if(!bSynchronized)
+    {
+        requestSnapshot();
+        return;
+    }
+
+    replayBuffered();
+}
+
+void RoomMembership::tick(float deltaTime)
+{
+    if(!bAwaitingSnapshot_) return;
+
+    retryTime_ -= deltaTime;
+    if(retryTime_ <= 0.f)
+    {
+        retryTime_ = SNAPSHOT_RETRY;
+        network_.requestRoomSnapshot();
+    }
+}
+
+bool RoomMembership::apply(const Delta& delta)
+{
+    switch(delta.change)
+    {
+        case EChange::Add:      return enter(delta.serverId, delta.name);
+        case EChange::Remove:   return leave(delta.serverId);
+        case EChange::Modify:   return rename(delta.serverId, delta.name);
+    }
+    return false;
+}
+
+bool RoomMembership::enter(uint64_t serverId, std::string_view name)
+{
+    auto& players = network_.getPlayers();
+    auto& events = network_.getEvents();
+
+    // Already in the room, an add of a known player only updates it
+    const auto existing = players.find(serverId);
+    if(existing.isValid() && !players.isPendingRemoval(existing)) return rename(serverId, name);
+
+    // Left earlier this frame, add cancels the pending removal and it enters again
+    const auto player = players.add(serverId, name);
+    if(!player.isValid()) return true; // Registry is full, a snapshot wouldn't fix it
+
+    if(!events.publish(NetworkEvent::PlayerEnterRoom{ player, name }))
+    {
+        if(existing.isValid()) players.removeLater(player);
+        else players.remove(player);
+        return false;
+    }
+
+    if(existing.isValid()) players.rename(player, name);
+    return true;
+}
+
+bool RoomMembership::leave(uint64_t serverId)
+{
+    auto& players = network_.getPlayers();
+
+    // Unknown, or already left this frame
+    const auto player = players.find(serverId);
+    if(!player.isValid() || players.isPendingRemoval(player)) return true;
+
+    if(!network_.getEvents().publish(NetworkEvent::PlayerLeaveRoom{ player })) return false;
+
+    players.removeLater(player);
+    return true;
+}
+
+bool RoomMembership::rename(uint64_t serverId, std::string_view name)
+{
+    auto& players = network_.getPlayers();
+
+    const auto player = players.find(serverId);
+    if(!player.isValid()) return false;
+
+    if(players.getPlayer(player).getName() == name) return true;
+
+    players.rename(player, name);
+    return network_.getEvents().publish(NetworkEvent::PlayerRenamed{ player, name });
+}
+
+void RoomMembership::buffer(const Delta& delta)
+{
+    // Too far behind, the snapshot will bring everything in the buffer anyway
+    if(buffered_.size() == MAX_BUFFERED) buffered_.clear();
+
+    BufferedDelta buffered;
+    buffered.version = delta.version;
+    buffered.change = delta.change;
+    buffered.serverId = delta.serverId;
+    buffered.nameLength = static_cast<uint8_t>(std::min(delta.name.size(), buffered.name.size()));
+    std::copy_n(delta.name.data(), buffered.nameLength, buffered.name.data());
+
+    buffered_.push_back(buffered);
+}
+
+void RoomMembership::replayBuffered()
+{
+    std::stable_sort(buffered_.begin(), buffered_.end(), [](const BufferedDelta& a, const BufferedDelta& b){ return a.version < b.version; });
+
+    bool bSynchronized = true;
+    size_t replayed = 0;
+    for(; replayed < buffered_.size(); replayed++)
+    {
+        const auto delta = buffered_[replayed].toDelta();
+        if(delta.version <= version_)
+        {
+            ++staleCount_;
+            continue;
+        }
+
+        if(delta.version != version_ + 1)
+        {
+            ++gapCount_;
+            break;
+        }
+
+        version_ = delta.version;
+        if(!apply(delta))
+        {
+            bSynchronized = false;
+            replayed++;
+            break;
+        }
+    }
+
+    buffered_.erase(buffered_.begin(), buffered_.begin() + static_cast<std::ptrdiff_t>(replayed));
+    if(!bSynchronized || !buffered_.empty()) requestSnapshot();
+}
+
+void RoomMembership::requestSnapshot()
+{
+    if(bAwaitingSnapshot_) return;
+
+    bAwaitingSnapshot_ = true;
+    retryTime_ = SNAPSHOT_RETRY;
+    network_.requestRoomSnapshot();
+}
@@ -0,0 +1,141 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <player/Player.hpp>
+
+namespace lpm
+{
+    class INetwork;
+
+    /**
+     * @brief Versioned membership of the current room.
+     *
+     * Server sends membership as numbered diffs: each one adds, removes or modifies a single player and carries the
+     * version it produces. Diffs are applied to the PlayerRegistry in order and turned into PlayerEnterRoom,
+     * PlayerLeaveRoom and PlayerRenamed events, so a sync costs O(changes) instead of O(room size).
+     *
+     * A full snapshot is only requested when a version is missing or a diff couldn't be delivered. Diffs received while
+     * waiting for it are buffered and the newer ones are replayed on top of the snapshot.
+     */
+    class RoomMembership
+    {
+    public:
+        static constexpr size_t MAX_BUFFERED    = 1024;
+        static constexpr float SNAPSHOT_RETRY   = 2.f;     //< Seconds before asking again for a snapshot
+
+        enum class EChange : uint8_t
+        {
+            Add,
+            Remove,
+            Modify
+        };
+
+        struct Delta
+        {
+            uint32_t version = 0;                   //< Membership version after applying this diff
+            EChange change = EChange::Add;
+            uint64_t serverId = 0;
+            std::string_view name;                  //< Used by Add and Modify
+        };
+
+        struct Member
+        {
+            uint64_t serverId = 0;
+            std::string_view name;
+        };
+
+    public:
+        explicit RoomMembership(INetwork& network);
+
+        RoomMembership(const RoomMembership&) = delete;
+        RoomMembership& operator=(const RoomMembership&) = delete;
+
+    public:
+        void applyDelta(const Delta& delta);
+
+        /**
+         * Replace membership with the full list of the room. Players missing from it leave, new ones enter.
+         */
+        void applySnapshot(uint32_t version, std::span<const Member> members);
+
+        /**
+         * Retry snapshot request if it's taking too long. INetwork::dispatch calls it.
+         */
+        void tick(float deltaTime);
+
+    public:
+        [[nodiscard]] uint32_t getVersion() const { return version_; }
+        [[nodiscard]] bool isSynchronized() const { return !bAwaitingSnapshot_; }
+
+        [[nodiscard]] size_t getBufferedCount() const { return buffered_.size(); }
+        [[nodiscard]] uint64_t getGapCount() const { return gapCount_; }
+        [[nodiscard]] uint64_t getSnapshotCount() const { return snapshotCount_; }
+        [[nodiscard]] uint64_t getStaleCount() const { return staleCount_; }
+
+    private:
+        struct BufferedDelta
+        {
+            uint32_t version = 0;
+            EChange change = EChange::Add;
+            uint64_t serverId = 0;
+            std::array<char, Player::MAX_NAME_LENGTH> name {};
+            uint8_t nameLength = 0;
+
+            [[nodiscard]] Delta toDelta() const { return { version, change, serverId, { name.data(), nameLength } }; }
+        };
+
+        /**
+         * Apply diff to registry and publish it
+         * @return False if it couldn't be delivered and membership is out of sync
+         */
+        bool apply(const Delta& delta);
+
+        bool enter(uint64_t serverId, std::string_view name);
+        bool leave(uint64_t serverId);
+        bool rename(uint64_t serverId, std::string_view name);
+
+        void buffer(const Delta& delta);
+        void replayBuffered();
+        void requestSnapshot();
+
+    private:
+        INetwork& network_;
+
+        uint32_t version_ = 0;
+        bool bAwaitingSnapshot_ = false;
+        float retryTime_ = 0.f;
+
+        std::vector<BufferedDelta> buffered_;
+        std::vector<uint8_t> keep_;                 //< Snapshot marks, indexed by registry dense index
+
+        uint64_t gapCount_ = 0;
+        uint64_t snapshotCount_ = 0;
+        uint64_t staleCount_ = 0;
+    };
+}
@@ -21,6 +21,15 @@
 
 #include "Player.hpp"
 
+#include <algorithm>
+
 using namespace lpm;
 
+void Player::reset(uint64_t serverId, std::string_view name)
+{
+    serverId_   = serverId;
+    nameLength_ = static_cast<uint8_t>(std::min(name.size(), MAX_NAME_LENGTH));
 
+    std::copy_n(name.data(), nameLength_, name_.data());
+    name_[nameLength_] = '\0';
+}
@@ -21,12 +21,32 @@
 
 #pragma once
 
-#include <string>
+#include <array>
+#include <cstdint>
+#include <string_view>
 
 namespace lpm
 {
+    /**
+     * @brief Cold data of a remote player.
+     *
+     * Players are owned by PlayerRegistry and recycled between joins, so the name is stored inline instead of
+     * in a std::string to keep join/leave free of allocations. Per-frame data lives in PlayerRegistry.
+     */
     class Player
     {
-        std::string name_;
+    public:
+        static constexpr size_t MAX_NAME_LENGTH = 31;
+
+    public:
+        void reset(uint64_t serverId, std::string_view name);
+
+        [[nodiscard]] uint64_t getServerID() const { return serverId_; }
+        [[nodiscard]] std::string_view getName() const { return { name_.data(), nameLength_ }; }
+
+    private:
+        uint64_t serverId_ = 0;
+        std::array<char, MAX_NAME_LENGTH + 1> name_ {};
+        uint8_t nameLength_ = 0;
     };
 }
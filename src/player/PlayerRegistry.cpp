@@ -0,0 +1,192 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "PlayerRegistry.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace lpm;
+
+PlayerRegistry::PlayerRegistry(size_t capacity)
+: pool_(capacity)
+, cold_(capacity)
+, index_(capacity)
+{
+    hot_.positions.resize(capacity);
+    hot_.cameras.resize(capacity);
+    hot_.cursorAnimations.resize(capacity);
+    hot_.cursorTimes.resize(capacity);
+    hot_.lastUpdates.resize(capacity);
+
+    pendingRemovals_.reserve(capacity);
+}
+
+PlayerID PlayerRegistry::add(uint64_t serverId, std::string_view name)
+{
+    if(const auto existing = find(serverId); existing.isValid())
+    {
+        // Left and came back before removals were flushed, keep it
+        std::erase(pendingRemovals_, existing);
+        return existing;
+    }
+
+    const auto player = pool_.acquire();
+    if(!player.isValid()) return {};
+
+    cold_[player.index].reset(serverId, name);
+
+    const auto dense = pool_.getDenseIndex(player);
+    hot_.positions[dense]        = {};
+    hot_.cameras[dense]          = 0;
+    hot_.cursorAnimations[dense] = 0;
+    hot_.cursorTimes[dense]      = 0;
+    hot_.lastUpdates[dense]      = time_;
+
+    index_.insert(serverId, player.index);
+
+    return player;
+}
+
+void PlayerRegistry::rename(PlayerID player, std::string_view name)
+{
+    if(isValid(player))
+    {
+        cold_[player.index].reset(cold_[player.index].getServerID(), name);
+    }
+}
+
+bool PlayerRegistry::remove(PlayerID player)
+{
+    if(!isValid(player)) return false;
+
+    index_.erase(cold_[player.index].getServerID());
+
+    // Mirror the dense swap made by the pool
+    const auto [dense, moved] = pool_.release(player);
+    hot_.positions[dense]        = hot_.positions[moved];
+    hot_.cameras[dense]          = hot_.cameras[moved];
+    hot_.cursorAnimations[dense] = hot_.cursorAnimations[moved];
+    hot_.cursorTimes[dense]      = hot_.cursorTimes[moved];
+    hot_.lastUpdates[dense]      = hot_.lastUpdates[moved];
+
+    return true;
+}
+
+void PlayerRegistry::removeLater(PlayerID player)
+{
+    if(isValid(player) && pendingRemovals_.size() < pendingRemovals_.capacity())
+    {
+        pendingRemovals_.push_back(player);
+    }
+}
+
+void PlayerRegistry::flushRemovals()
+{
+    for(const auto player : pendingRemovals_)
+    {
+        remove(player);
+    }
+    pendingRemovals_.clear();
+}
+
+void PlayerRegistry::clear()
+{
+    pendingRemovals_.clear();
+    while(size() > 0)
+    {
+        remove(getPlayerAt(size() - 1));
+    }
+}
+
+void PlayerRegistry::tick(float deltaTime)
+{
+    time_ += deltaTime;
+
+    for(auto& cursorTime : std::span(hot_.cursorTimes.data(), size()))
+    {
+        cursorTime += deltaTime;
+    }
+}
+
+PlayerID PlayerRegistry::find(uint64_t serverId) const
+{
+    const auto slot = index_.find(serverId);
+    return slot != ServerIDIndex::INVALID_SLOT ? pool_.getSlotHandle(slot) : PlayerID{};
+}
+
+bool PlayerRegistry::isValid(PlayerID player) const
+{
+    return pool_.isAlive(player);
+}
+
+bool PlayerRegistry::isPendingRemoval(PlayerID player) const
+{
+    return std::ranges::find(pendingRemovals_, player) != pendingRemovals_.end();
+}
+
+const Player& PlayerRegistry::getPlayer(PlayerID player) const
+{
+    assert(isValid(player) && "Trying to get an invalid player");
+    return cold_[player.index];
+}
+
+void PlayerRegistry::setPosition(PlayerID player, sf::Vector2f position)
+{
+    if(!isValid(player)) return;
+
+    const auto dense = pool_.getDenseIndex(player);
+    hot_.positions[dense]   = position;
+    hot_.lastUpdates[dense] = time_;
+}
+
+void PlayerRegistry::setCamera(PlayerID player, uint32_t cameraHash)
+{
+    if(!isValid(player)) return;
+
+    const auto dense = pool_.getDenseIndex(player);
+    hot_.cameras[dense]     = cameraHash;
+    hot_.lastUpdates[dense] = time_;
+}
+
+void PlayerRegistry::setCursorAnimation(PlayerID player, uint16_t animation)
+{
+    if(!isValid(player)) return;
+
+    const auto dense = pool_.getDenseIndex(player);
+    if(hot_.cursorAnimations[dense] != animation)
+    {
+        hot_.cursorAnimations[dense] = animation;
+        hot_.cursorTimes[dense]      = 0;
+    }
+}
+
+sf::Vector2f PlayerRegistry::getPosition(PlayerID player) const
+{
+    assert(isValid(player) && "Trying to get position of an invalid player");
+    return hot_.positions[pool_.getDenseIndex(player)];
+}
+
+uint32_t PlayerRegistry::getCamera(PlayerID player) const
+{
+    assert(isValid(player) && "Trying to get camera of an invalid player");
+    return hot_.cameras[pool_.getDenseIndex(player)];
+}
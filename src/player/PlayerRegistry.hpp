@@ -0,0 +1,147 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <SFML/System/Vector2.hpp>
+
+#include <components/HandlePool.hpp>
+#include <components/ServerIDIndex.hpp>
+#include <player/Player.hpp>
+
+namespace lpm
+{
+    using PlayerID = Handle<Player>;
+
+    /**
+     * @brief Pool of remote players.
+     *
+     * Players are referenced by generational PlayerID, so a handle kept after the player left is detected instead of
+     * pointing to whoever reused the slot. Data is split in two:
+     * - Hot data, touched every frame (position, camera, cursor animation, last update), stored as structure of arrays
+     *   packed by dense index. Iterating getPositions() and friends walks contiguous memory with no holes.
+     * - Cold data (Player: name, server id), stored by slot and only read on demand.
+     *
+     * Server ids are resolved to slots with an open addressing table. All memory is reserved on construction, so
+     * players joining and leaving never allocate.
+     */
+    class PlayerRegistry
+    {
+    public:
+        static constexpr size_t DEFAULT_CAPACITY = 1024;
+
+    public:
+        explicit PlayerRegistry(size_t capacity = DEFAULT_CAPACITY);
+
+    public:
+        /**
+         * Add a player, or return the existing one if serverId is already registered. A pending removeLater of the
+         * existing player is cancelled.
+         * @return PlayerID of the player, invalid if registry is full
+         */
+        PlayerID add(uint64_t serverId, std::string_view name);
+
+        /**
+         * Change name of player
+         */
+        void rename(PlayerID player, std::string_view name);
+
+        /**
+         * Remove player. PlayerID and any copy of it become invalid.
+         * @return False if player wasn't registered
+         */
+        bool remove(PlayerID player);
+
+        /**
+         * Remove player after current dispatch, so handlers of PlayerLeaveRoom can still read it.
+         * Network implementations call it when a player leaves, INetwork::dispatch flushes it.
+         */
+        void removeLater(PlayerID player);
+
+        /**
+         * Remove players queued with removeLater
+         */
+        void flushRemovals();
+
+        /**
+         * Remove every player
+         */
+        void clear();
+
+        /**
+         * Advance registry clock and cursor animations of every player
+         */
+        void tick(float deltaTime);
+
+    public:
+        [[nodiscard]] PlayerID find(uint64_t serverId) const;
+        [[nodiscard]] bool isValid(PlayerID player) const;
+        [[nodiscard]] bool isPendingRemoval(PlayerID player) const;
+
+        [[nodiscard]] const Player& getPlayer(PlayerID player) const;
+
+        void setPosition(PlayerID player, sf::Vector2f position);
+        void setCamera(PlayerID player, uint32_t cameraHash);
+        void setCursorAnimation(PlayerID player, uint16_t animation);
+
+        [[nodiscard]] sf::Vector2f getPosition(PlayerID player) const;
+        [[nodiscard]] uint32_t getCamera(PlayerID player) const;
+
+        [[nodiscard]] size_t size() const { return pool_.size(); }
+        [[nodiscard]] size_t capacity() const { return pool_.capacity(); }
+
+        /**
+         * Hot arrays, all of them indexed by the same dense index in [0, size())
+         */
+        [[nodiscard]] PlayerID getPlayerAt(size_t dense) const { return pool_.getHandle(dense); }
+        [[nodiscard]] size_t getDenseIndex(PlayerID player) const { return pool_.getDenseIndex(player); }
+        [[nodiscard]] std::span<const sf::Vector2f> getPositions() const { return { hot_.positions.data(), size() }; }
+        [[nodiscard]] std::span<const uint32_t> getCameras() const { return { hot_.cameras.data(), size() }; }
+        [[nodiscard]] std::span<const uint16_t> getCursorAnimations() const { return { hot_.cursorAnimations.data(), size() }; }
+        [[nodiscard]] std::span<const float> getCursorTimes() const { return { hot_.cursorTimes.data(), size() }; }
+        [[nodiscard]] std::span<const float> getLastUpdates() const { return { hot_.lastUpdates.data(), size() }; }
+
+        [[nodiscard]] float getTime() const { return time_; }
+
+    private:
+        struct HotData
+        {
+            std::vector<sf::Vector2f> positions;
+            std::vector<uint32_t> cameras;
+            std::vector<uint16_t> cursorAnimations;
+            std::vector<float> cursorTimes;
+            std::vector<float> lastUpdates;
+        };
+
+    private:
+        HandlePool<Player> pool_;
+        HotData hot_;                           //< Indexed by dense index
+        std::vector<Player> cold_;              //< Indexed by slot
+        ServerIDIndex index_;                   //< Server id to slot
+        std::vector<PlayerID> pendingRemovals_; //< Players removed with removeLater
+        float time_ = 0;
+    };
+}
@@ -0,0 +1,112 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "CullingGrid.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace lpm;
+
+void CullingGrid::clear()
+{
+    for(auto& [key, ids] : cells_)
+    {
+        ids.clear();
+    }
+    oversized_.clear();
+    stamps_.clear();
+    query_ = 0;
+}
+
+void CullingGrid::insert(uint32_t id, const sf::FloatRect& bounds)
+{
+    if(id >= stamps_.size()) stamps_.resize(id + 1, 0);
+
+    const auto cells = getCells(bounds);
+    if(static_cast<int64_t>(cells.right - cells.left + 1) * (cells.bottom - cells.top + 1) > MAX_ITEM_CELLS)
+    {
+        oversized_.push_back(id);
+        return;
+    }
+
+    for(int y = cells.top; y <= cells.bottom; y++)
+    {
+        for(int x = cells.left; x <= cells.right; x++)
+        {
+            cells_[getCellKey(x, y)].push_back(id);
+        }
+    }
+}
+
+void CullingGrid::query(const sf::FloatRect& area, std::vector<uint32_t>& ids) const
+{
+    ids.clear();
+
+    // Stamps tell apart ids already returned by this query, a wrap clears them
+    if(++query_ == 0)
+    {
+        std::ranges::fill(stamps_, 0);
+        query_ = 1;
+    }
+
+    for(const auto id : oversized_) visit(id, ids);
+
+    const auto cells = getCells(area);
+    for(int y = cells.top; y <= cells.bottom; y++)
+    {
+        for(int x = cells.left; x <= cells.right; x++)
+        {
+            const auto cell = cells_.find(getCellKey(x, y));
+            if(cell == cells_.end()) continue;
+
+            for(const auto id : cell->second) visit(id, ids);
+        }
+    }
+}
+
+CullingGrid::CellRange CullingGrid::getCells(const sf::FloatRect& bounds)
+{
+    // Clamped, so huge rectangles don't overflow, they end up oversized anyway
+    const auto toCell = [](float coord){
+        return static_cast<int>(std::clamp(std::floor(coord / CELL_SIZE), -1e6f, 1e6f));
+    };
+
+    return {
+        toCell(bounds.left),
+        toCell(bounds.top),
+        toCell(bounds.left + bounds.width),
+        toCell(bounds.top + bounds.height)
+    };
+}
+
+uint64_t CullingGrid::getCellKey(int x, int y)
+{
+    return static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32 | static_cast<uint32_t>(y);
+}
+
+void CullingGrid::visit(uint32_t id, std::vector<uint32_t>& ids) const
+{
+    if(stamps_[id] == query_) return;
+
+    stamps_[id] = query_;
+    ids.push_back(id);
+}
@@ -0,0 +1,76 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <SFML/Graphics/Rect.hpp>
+
+namespace lpm
+{
+    /**
+     * @brief Coarse uniform grid of rectangles, to find those near an area without testing all of them.
+     *
+     * Every id is stored in the CELL_SIZE cells its bounds touch. Queries return each id once, from the cells the
+     * area touches, so callers still test exact bounds. Rectangles covering more than MAX_ITEM_CELLS are kept apart
+     * and returned by every query.
+     */
+    class CullingGrid
+    {
+    public:
+        static constexpr float CELL_SIZE = 128.f;
+        static constexpr int MAX_ITEM_CELLS = 64;
+
+    public:
+        void clear();
+        void insert(uint32_t id, const sf::FloatRect& bounds);
+
+        /**
+         * Get ids whose cells touch area, without duplicates
+         * @param ids Cleared before adding ids
+         */
+        void query(const sf::FloatRect& area, std::vector<uint32_t>& ids) const;
+
+    private:
+        struct CellRange
+        {
+            int left;
+            int top;
+            int right;      //< Inclusive
+            int bottom;     //< Inclusive
+        };
+
+        static CellRange getCells(const sf::FloatRect& bounds);
+        static uint64_t getCellKey(int x, int y);
+
+        void visit(uint32_t id, std::vector<uint32_t>& ids) const;
+
+    private:
+        std::unordered_map<uint64_t, std::vector<uint32_t>> cells_;
+        std::vector<uint32_t> oversized_;               //< Ids touching too many cells
+
+        mutable std::vector<uint32_t> stamps_;          //< Last query that returned each id
+        mutable uint32_t query_ = 0;
+    };
+}
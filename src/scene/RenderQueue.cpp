@@ -0,0 +1,294 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "RenderQueue.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <limits>
+
+#include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Shape.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+#include <SFML/Graphics/Text.hpp>
+
+#include <components/Material.hpp>
+
+using namespace lpm;
+
+namespace
+{
+    /**
+     * Get 1 based id of pointer in ids, adding it if missing. Saturates at max, which only costs sorting precision.
+     */
+    template<typename Id, typename T>
+    Id getId(std::vector<const T*>& ids, const T* pointer)
+    {
+        if(!pointer) return 0;
+
+        if(const auto it = std::ranges::find(ids, pointer); it != ids.end())
+        {
+            return static_cast<Id>(it - ids.begin() + 1);
+        }
+
+        if(ids.size() >= std::numeric_limits<Id>::max()) return std::numeric_limits<Id>::max();
+
+        ids.push_back(pointer);
+        return static_cast<Id>(ids.size());
+    }
+
+    /**
+     * Append two triangles of glyph at pen position, as sf::Text does
+     */
+    void appendGlyph(std::vector<sf::Vertex>& vertices, sf::Vector2f position, const sf::Color& color, const sf::Glyph& glyph)
+    {
+        constexpr float PADDING = 1.f;
+
+        const float left   = position.x + glyph.bounds.left - PADDING;
+        const float top    = position.y + glyph.bounds.top - PADDING;
+        const float right  = position.x + glyph.bounds.left + glyph.bounds.width + PADDING;
+        const float bottom = position.y + glyph.bounds.top + glyph.bounds.height + PADDING;
+
+        const float u1 = static_cast<float>(glyph.textureRect.left) - PADDING;
+        const float v1 = static_cast<float>(glyph.textureRect.top) - PADDING;
+        const float u2 = static_cast<float>(glyph.textureRect.left + glyph.textureRect.width) + PADDING;
+        const float v2 = static_cast<float>(glyph.textureRect.top + glyph.textureRect.height) + PADDING;
+
+        vertices.emplace_back(sf::Vector2f(left,  top),    color, sf::Vector2f(u1, v1));
+        vertices.emplace_back(sf::Vector2f(right, top),    color, sf::Vector2f(u2, v1));
+        vertices.emplace_back(sf::Vector2f(left,  bottom), color, sf::Vector2f(u1, v2));
+        vertices.emplace_back(sf::Vector2f(left,  bottom), color, sf::Vector2f(u1, v2));
+        vertices.emplace_back(sf::Vector2f(right, top),    color, sf::Vector2f(u2, v1));
+        vertices.emplace_back(sf::Vector2f(right, bottom), color, sf::Vector2f(u2, v2));
+    }
+}
+
+void RenderQueue::clear()
+{
+    commands_.clear();
+    vertices_.clear();
+    entries_.clear();
+    shaders_.clear();
+    textures_.clear();
+}
+
+void RenderQueue::submit(std::span<const sf::Vertex> vertices, sf::PrimitiveType type, const sf::RenderStates& states,
+                         const SceneNode::SceneNodeID& id, uint8_t order, Material* material)
+{
+    vertices_.insert(vertices_.end(), vertices.begin(), vertices.end());
+    push(vertices.size(), type, states, id, order, material);
+}
+
+void RenderQueue::submit(const sf::Sprite& sprite, const sf::RenderStates& states, const SceneNode::SceneNodeID& id, uint8_t order)
+{
+    if(!sprite.getTexture()) return;
+
+    const auto size  = sprite.getLocalBounds();
+    const auto rect  = sf::FloatRect(sprite.getTextureRect());
+    const auto color = sprite.getColor();
+
+    vertices_.emplace_back(sf::Vector2f(0.f,        0.f),         color, sf::Vector2f(rect.left,              rect.top));
+    vertices_.emplace_back(sf::Vector2f(0.f,        size.height), color, sf::Vector2f(rect.left,              rect.top + rect.height));
+    vertices_.emplace_back(sf::Vector2f(size.width, 0.f),         color, sf::Vector2f(rect.left + rect.width, rect.top));
+    vertices_.emplace_back(sf::Vector2f(size.width, size.height), color, sf::Vector2f(rect.left + rect.width, rect.top + rect.height));
+
+    sf::RenderStates spriteStates = states;
+    spriteStates.transform *= sprite.getTransform();
+    spriteStates.texture = sprite.getTexture();
+    push(4, sf::TriangleStrip, spriteStates, id, order, nullptr);
+}
+
+void RenderQueue::submit(const sf::Shape& shape, const sf::RenderStates& states, const SceneNode::SceneNodeID& id,
+                         uint8_t order, Material* material)
+{
+    const auto count = shape.getPointCount();
+    if(count < 3) return;
+
+    sf::FloatRect bounds(shape.getPoint(0), {});
+    for(size_t i = 1; i < count; i++)
+    {
+        const auto point = shape.getPoint(i);
+        const auto right  = std::max(bounds.left + bounds.width, point.x);
+        const auto bottom = std::max(bounds.top + bounds.height, point.y);
+        bounds.left   = std::min(bounds.left, point.x);
+        bounds.top    = std::min(bounds.top, point.y);
+        bounds.width  = right - bounds.left;
+        bounds.height = bottom - bounds.top;
+    }
+
+    // Texture rect is stretched over the bounds of the points
+    const auto rect  = sf::FloatRect(shape.getTextureRect());
+    const auto color = shape.getFillColor();
+    for(size_t i = 0; i < count; i++)
+    {
+        const auto point = shape.getPoint(i);
+        const float x = bounds.width > 0.f ? (point.x - bounds.left) / bounds.width : 0.f;
+        const float y = bounds.height > 0.f ? (point.y - bounds.top) / bounds.height : 0.f;
+        vertices_.emplace_back(point, color, sf::Vector2f(rect.left + rect.width * x, rect.top + rect.height * y));
+    }
+
+    // Shapes are convex, a fan from the first point covers them
+    sf::RenderStates shapeStates = states;
+    shapeStates.transform *= shape.getTransform();
+    shapeStates.texture = shape.getTexture();
+    push(count, sf::TriangleFan, shapeStates, id, order, material);
+}
+
+void RenderQueue::submit(const sf::Text& text, const sf::RenderStates& states, const SceneNode::SceneNodeID& id, uint8_t order)
+{
+    const auto* font = text.getFont();
+    if(!font) return;
+
+    assert(text.getStyle() == sf::Text::Regular && text.getOutlineThickness() == 0.f && "RenderQueue draws regular text only");
+
+    const auto& string = text.getString();
+    const auto size  = text.getCharacterSize();
+    const auto color = text.getFillColor();
+
+    // Same layout as sf::Text
+    float whitespaceWidth = font->getGlyph(U' ', size, false).advance;
+    const float letterSpacing = (whitespaceWidth / 3.f) * (text.getLetterSpacing() - 1.f);
+    whitespaceWidth += letterSpacing;
+    const float lineSpacing = font->getLineSpacing(size) * text.getLineSpacing();
+
+    const auto firstVertex = vertices_.size();
+    sf::Vector2f pen(0.f, static_cast<float>(size));
+    uint32_t previous = 0;
+
+    for(size_t i = 0; i < string.getSize(); i++)
+    {
+        const uint32_t character = string[i];
+        if(character == U'\r') continue;
+
+        pen.x += font->getKerning(previous, character, size);
+        previous = character;
+
+        switch(character)
+        {
+            case U' ':  pen.x += whitespaceWidth; continue;
+            case U'\t': pen.x += whitespaceWidth * 4.f; continue;
+            case U'\n': pen.y += lineSpacing; pen.x = 0.f; continue;
+            default: break;
+        }
+
+        const auto& glyph = font->getGlyph(character, size, false);
+        appendGlyph(vertices_, pen, color, glyph);
+        pen.x += glyph.advance + letterSpacing;
+    }
+
+    const auto count = vertices_.size() - firstVertex;
+    if(count == 0) return;
+
+    // Page is taken after the glyphs were loaded into it
+    sf::RenderStates textStates = states;
+    textStates.transform *= text.getTransform();
+    textStates.texture = &font->getTexture(size);
+    push(count, sf::Triangles, textStates, id, order, nullptr);
+}
+
+void RenderQueue::push(size_t count, sf::PrimitiveType type, const sf::RenderStates& states, const SceneNode::SceneNodeID& id,
+                       uint8_t order, Material* material)
+{
+    const auto key = makeKey(id.group, id.depth, order, getShaderId(states.shader), getTextureId(states.texture));
+    entries_.push_back({ key, static_cast<uint32_t>(commands_.size()) });
+    commands_.push_back({ states, material, static_cast<uint32_t>(vertices_.size() - count), static_cast<uint32_t>(count), type });
+}
+
+void RenderQueue::finish()
+{
+    sort();
+
+    stats_ = {};
+    const Command* previous = nullptr;
+
+    for(const auto& entry : entries_)
+    {
+        const auto& command = commands_[entry.command];
+
+        // First command counts as a change of everything it binds
+        if(!previous ? command.states.texture != nullptr : command.states.texture != previous->states.texture) stats_.textureChanges++;
+        if(!previous ? command.states.shader != nullptr : command.states.shader != previous->states.shader) stats_.shaderChanges++;
+        if(previous && command.states.blendMode != previous->states.blendMode) stats_.blendChanges++;
+
+        stats_.drawCalls++;
+        previous = &command;
+    }
+}
+
+void RenderQueue::execute(sf::RenderTarget& target) const
+{
+    for(const auto& entry : entries_)
+    {
+        const auto& command = commands_[entry.command];
+
+        if(command.material) command.material->apply();
+        target.draw(&vertices_[command.first], command.count, command.type, command.states);
+    }
+}
+uint64_t RenderQueue::makeKey(uint16_t group, uint16_t depth, uint8_t order, uint8_t shader, uint16_t texture)
+{
+    return static_cast<uint64_t>(group) << 48
+         | static_cast<uint64_t>(depth) << 32
+         | static_cast<uint64_t>(order) << 24
+         | static_cast<uint64_t>(shader) << 16
+         | static_cast<uint64_t>(texture);
+}
+
+uint8_t RenderQueue::getShaderId(const sf::Shader* shader)
+{
+    return getId<uint8_t>(shaders_, shader);
+}
+
+uint16_t RenderQueue::getTextureId(const sf::Texture* texture)
+{
+    return getId<uint16_t>(textures_, texture);
+}
+
+void RenderQueue::sort()
+{
+    if(entries_.size() < 2) return;
+
+    // Bytes every key shares don't reorder anything
+    uint64_t differing = 0;
+    for(const auto& entry : entries_) differing |= entry.key ^ entries_.front().key;
+
+    scratch_.resize(entries_.size());
+    for(unsigned shift = 0; shift < 64; shift += 8)
+    {
+        if(((differing >> shift) & 0xFF) == 0) continue;
+
+        std::array<uint32_t, 256> offsets = {};
+        for(const auto& entry : entries_) offsets[(entry.key >> shift) & 0xFF]++;
+
+        uint32_t offset = 0;
+        for(auto& count : offsets)
+        {
+            const auto size = count;
+            count = offset;
+            offset += size;
+        }
+
+        for(const auto& entry : entries_) scratch_[offsets[(entry.key >> shift) & 0xFF]++] = entry;
+        std::swap(entries_, scratch_);
+    }
+}
@@ -0,0 +1,161 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <SFML/Graphics/PrimitiveType.hpp>
+#include <SFML/Graphics/RenderStates.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+
+#include <scene/SceneNode.hpp>
+
+namespace sf
+{
+    class RenderTarget;
+    class Shape;
+    class Sprite;
+    class Text;
+}
+
+namespace lpm
+{
+    class Material;
+
+    /**
+     * @brief Draw commands of a frame, sorted before they reach the target.
+     *
+     * Nodes submit what they draw instead of drawing it. Every command gets a 64 bit key, from most to least
+     * significant bits:
+     *
+     *  | group 16 | depth 16 | order 8 | shader 8 | texture 16 |
+     *
+     * so commands keep the scene order, and inside one depth those sharing shader and texture end up together and
+     * the target doesn't rebind them. Order lets a node keep several of its commands in sequence, shader and texture
+     * are ids given in the order they are first submitted each frame. Sort is a stable radix sort, equal keys are
+     * drawn as submitted.
+     *
+     * Commands are snapshots: sprites, shapes and texts are copied as vertices with their final transform, so
+     * execute() only reads the queue and can run in another thread while nodes change. Textures and shaders are kept
+     * as handles, whoever owns them must keep them alive until the frame is drawn (Scene::retire).
+     */
+    class RenderQueue
+    {
+    public:
+        /**
+         * Counters of last finished frame
+         */
+        struct Stats
+        {
+            uint32_t drawCalls = 0;
+            uint32_t textureChanges = 0;
+            uint32_t shaderChanges = 0;
+            uint32_t blendChanges = 0;
+
+            [[nodiscard]] uint32_t getStateChanges() const { return textureChanges + shaderChanges + blendChanges; }
+        };
+
+    public:
+        /**
+         * Drop commands of previous frame
+         */
+        void clear();
+
+        /**
+         * Queue copy of vertices, drawn with states
+         * @param order Position among commands of the same node and depth
+         * @param material Uniforms of states.shader recorded with Material::record, uploaded right before the draw
+         */
+        void submit(std::span<const sf::Vertex> vertices, sf::PrimitiveType type, const sf::RenderStates& states,
+                    const SceneNode::SceneNodeID& id, uint8_t order = 0, Material* material = nullptr);
+
+        /**
+         * Queue sprite, sorted by its texture
+         */
+        void submit(const sf::Sprite& sprite, const sf::RenderStates& states, const SceneNode::SceneNodeID& id, uint8_t order = 0);
+
+        /**
+         * Queue fill of shape, sorted by its texture. Outline isn't drawn.
+         */
+        void submit(const sf::Shape& shape, const sf::RenderStates& states, const SceneNode::SceneNodeID& id,
+                    uint8_t order = 0, Material* material = nullptr);
+
+        /**
+         * Queue glyphs of text, sorted by the page texture of its font. Only regular style without outline.
+         * Missing glyphs are loaded here, so fonts aren't changed while a recorded frame is drawn.
+         */
+        void submit(const sf::Text& text, const sf::RenderStates& states, const SceneNode::SceneNodeID& id, uint8_t order = 0);
+
+        /**
+         * Sort commands and count the state changes drawing them makes. Call it once every command is submitted.
+         */
+        void finish();
+
+        /**
+         * Draw finished commands into target
+         */
+        void execute(sf::RenderTarget& target) const;
+
+        [[nodiscard]] const Stats& getStats() const { return stats_; }
+
+        [[nodiscard]] static uint64_t makeKey(uint16_t group, uint16_t depth, uint8_t order, uint8_t shader, uint16_t texture);
+
+    private:
+        struct Command
+        {
+            sf::RenderStates states;        //< Transform of the drawable included
+            Material* material;
+            uint32_t first;                 //< First vertex in vertices_
+            uint32_t count;
+            sf::PrimitiveType type;
+        };
+
+        struct SortEntry
+        {
+            uint64_t key;
+            uint32_t command;
+        };
+
+        /**
+         * Queue last count vertices of vertices_
+         */
+        void push(size_t count, sf::PrimitiveType type, const sf::RenderStates& states, const SceneNode::SceneNodeID& id,
+                  uint8_t order, Material* material);
+
+        uint8_t getShaderId(const sf::Shader* shader);
+        uint16_t getTextureId(const sf::Texture* texture);
+        void sort();
+
+    private:
+        std::vector<Command> commands_;
+        std::vector<sf::Vertex> vertices_;          //< Copied vertices of every command
+        std::vector<SortEntry> entries_;
+        std::vector<SortEntry> scratch_;            //< Radix sort ping-pong buffer
+
+        std::vector<const sf::Shader*> shaders_;    //< Id - 1 of shaders seen this frame
+        std::vector<const sf::Texture*> textures_;  //< Id - 1 of textures seen this frame
+
+        Stats stats_;
+    };
+}
@@ -0,0 +1,132 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "RenderThread.hpp"
+
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/OpenGL.hpp>
+
+#include <components/RenderScale.hpp>
+#include <scene/Scene.hpp>
+
+using namespace lpm;
+
+RenderThread::RenderThread(unsigned maxScale, bool bSmooth, sf::Vector2u windowSize)
+{
+    for(auto& target : targets_)
+    {
+        target = std::make_unique<RenderScale>(maxScale, bSmooth, windowSize);
+        target->release();
+    }
+
+    worker_ = std::thread(&RenderThread::work, this);
+}
+
+RenderThread::~RenderThread()
+{
+    {
+        std::scoped_lock lock(mutex_);
+        bStop_ = true;
+    }
+    wakeUp_.notify_one();
+    worker_.join();
+}
+
+void RenderThread::submit(const Scene& scene)
+{
+    wait();
+
+    // Render thread is idle, so the back target isn't being drawn and the last recording can be replaced
+    scene.record(targets_[1 - front_]->getSize());
+
+    {
+        std::scoped_lock lock(mutex_);
+        scene_ = &scene;
+        bPending_ = true;
+    }
+    wakeUp_.notify_one();
+}
+
+void RenderThread::wait()
+{
+    std::unique_lock lock(mutex_);
+    done_.wait(lock, [this](){ return !bPending_; });
+}
+
+void RenderThread::resize(sf::Vector2u windowSize)
+{
+    wait();
+
+    for(auto& target : targets_)
+    {
+        target->resize(windowSize);
+        target->release();
+    }
+}
+
+void RenderThread::present(sf::RenderTarget& window) const
+{
+    size_t front;
+    {
+        std::scoped_lock lock(mutex_);
+        if(!bHasFrame_) return;
+        front = front_;
+    }
+
+    targets_[front]->present(window);
+}
+
+unsigned RenderThread::getScale() const
+{
+    return targets_[0]->getScale();
+}
+
+void RenderThread::work()
+{
+    while(true)
+    {
+        const Scene* scene;
+        {
+            std::unique_lock lock(mutex_);
+            wakeUp_.wait(lock, [this](){ return bPending_ || bStop_; });
+            if(bStop_) return;
+
+            scene = scene_;
+        }
+
+        // Only this thread changes front_
+        auto& target = *targets_[1 - front_];
+        scene->execute(target.begin());
+        target.end();
+
+        // Window samples the target from the main thread context, it must be complete
+        glFinish();
+        target.release();
+
+        {
+            std::scoped_lock lock(mutex_);
+            front_ = 1 - front_;
+            bHasFrame_ = true;
+            bPending_ = false;
+        }
+        done_.notify_all();
+    }
+}
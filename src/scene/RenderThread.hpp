@@ -0,0 +1,107 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <SFML/System/Vector2.hpp>
+
+namespace sf
+{
+    class RenderTarget;
+}
+
+namespace lpm
+{
+    class RenderScale;
+    class Scene;
+
+    /**
+     * @brief Draws scenes in its own thread while the main thread presents and prepares the next frame.
+     *
+     * The main thread records the scene (Scene::record: culling, sort keys, and a copy of the vertices, transform,
+     * texture, shader and blend mode of every draw) and submits it. The render thread executes the recording into one
+     * of two RenderScale targets, and the main thread keeps presenting the other one, which holds the previous frame,
+     * with GUI and cursor on top. Scenes are shown one frame late.
+     *
+     * Recordings don't point into nodes, so the scene ticks while its last recording is drawn; textures the recording
+     * uses are kept alive by Scene::retire. On software GL, drawing the scene costs the most and it overlaps with
+     * ticking, presenting, the frame limiter and event handling.
+     */
+    class RenderThread
+    {
+    public:
+        /**
+         * @throw render_scale_exception if targets can't be created
+         */
+        RenderThread(unsigned maxScale, bool bSmooth, sf::Vector2u windowSize);
+        ~RenderThread();
+
+        RenderThread(const RenderThread&) = delete;
+        RenderThread& operator=(const RenderThread&) = delete;
+
+    public:
+        /**
+         * Record scene and draw it in the render thread. Waits for the previous one first, right before recording.
+         */
+        void submit(const Scene& scene);
+
+        /**
+         * Block until last submitted scene is drawn, scene can be deleted after
+         */
+        void wait();
+
+        /**
+         * Resize targets as RenderScale::resize, waits for the render thread first
+         * @throw render_scale_exception if targets can't be created
+         */
+        void resize(sf::Vector2u windowSize);
+
+        /**
+         * Draw last finished frame into window, nothing before the first one
+         */
+        void present(sf::RenderTarget& window) const;
+
+        [[nodiscard]] unsigned getScale() const;
+
+    private:
+        void work();
+
+    private:
+        std::array<std::unique_ptr<RenderScale>, 2> targets_;
+        size_t front_ = 0;                          //< Target with last finished frame, the other one is drawn
+        bool bHasFrame_ = false;
+
+        const Scene* scene_ = nullptr;              //< Scene whose recording is drawn
+        mutable std::mutex mutex_;
+        std::condition_variable wakeUp_;
+        std::condition_variable done_;
+        bool bPending_ = false;                     //< Submitted scene not drawn yet
+        bool bStop_ = false;
+
+        std::thread worker_;                        //< Last member, so it starts after everything else is ready
+    };
+}
@@ -21,7 +21,14 @@
 
 #include "Scene.hpp"
 
-#include <SFML/Graphics/RenderTarget.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include <SFML/Graphics/RenderTexture.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/OpenGL.hpp>
 
 #include <Engine.hpp>
 #include <scene/SceneNode.hpp>
@@ -47,11 +54,62 @@ void Scene::tick(float deltaTime)
 {
     for(auto const& node : nodes_)
     {
-        node->tick(deltaTime);
+        if(!node->isPendingToRemove()) node->tick(deltaTime);
     }
+
+    flushRemovals();
 }
 
 void Scene::draw(sf::RenderTarget& target, const sf::RenderStates states) const
+{
+    record(target.getSize(), states);
+    execute(target);
+}
+
+void Scene::retire(std::unique_ptr<sf::Texture> texture)
+{
+    if(texture) retired_.push_back(std::move(texture));
+}
+
+void Scene::record(sf::Vector2u targetSize, const sf::RenderStates& states) const
+{
+    // Last recording was drawn, nothing points to retired textures or removed nodes anymore
+    retired_.clear();
+    removedNodes_.clear();
+
+    for(auto const& node : nodes_)
+    {
+        if(!node->isPendingToRemove()) node->prepare();
+    }
+
+    // Before draw, sort all SceneNodes based on his SceneNode::SceneNodeID
+    nodes_.sort([](auto& a, auto& b){ return *a < *b; });
+
+    cull(getViewArea());
+
+    // Then, queue all of them group by group
+    queue_.clear();
+    for(auto first = nodes_.cbegin(); first != nodes_.cend();)
+    {
+        const auto group = (*first)->getSceneNodeID().group;
+        const auto last = std::find_if(first, nodes_.cend(), [group](auto& node){ return node->getSceneNodeID().group != group; });
+
+        const auto layer = staticLayers_.find(group);
+        if(layer == staticLayers_.end() || !submitStaticLayer(layer->second, first, last, targetSize, states))
+        {
+            for(auto it = first; it != last; ++it)
+            {
+                if(!(*it)->isPendingToRemove() && (*it)->bVisible_) (*it)->submit(queue_, states);
+            }
+        }
+
+        first = last;
+    }
+
+    queue_.finish();
+}
+
+void Scene::execute(sf::RenderTarget& target) const
 {
     // Store original view to restore it later
     sf::View const originalView = target.getView();
@@ -63,26 +121,151 @@ void Scene::draw(sf::RenderTarget& target, const sf::RenderStates states) const
         AspectRatio::EAspectRatioRule::FitToParent
     ));
 
-    // Before draw, sort all SceneNodes based on his SceneNode::SceneNodeID
-    nodes_.sort([](auto& a, auto& b){ return *a < *b; });
+    // Then, draw them sorted
+    queue_.execute(target);
+
+    // Restore original view
+    target.setView(originalView);
+}
+
+bool Scene::submitStaticLayer(StaticLayer& layer, SceneNodesPtr::const_iterator first, SceneNodesPtr::const_iterator last,
+                              sf::Vector2u targetSize, const sf::RenderStates& states) const
+{
+    const sf::Vector2f sceneSize = { Configuration::BACKGROUND_TEX_SIZE_X, Configuration::BACKGROUND_TEX_SIZE_Y };
+
+    // Cached at the pixels the scene covers in target, so drawing it back doesn't resample
+    const auto viewport = AspectRatio::getViewportSize(
+        {Configuration::BACKGROUND_TEX_SIZE_X, Configuration::BACKGROUND_TEX_SIZE_Y},
+        targetSize,
+        AspectRatio::EAspectRatioRule::FitToParent
+    );
+    const sf::Vector2u size = {
+        std::max(1u, static_cast<unsigned>(std::lround(viewport.x))),
+        std::max(1u, static_cast<unsigned>(std::lround(viewport.y)))
+    };
+
+    if(!layer.target || layer.target->getSize() != size)
+    {
+        if(!layer.target) layer.target = std::make_unique<sf::RenderTexture>();
+        if(!layer.target->create(size.x, size.y))
+        {
+            layer.target.reset();
+            return false;
+        }
+
+        layer.target->setView(sf::View({ 0.f, 0.f, sceneSize.x, sceneSize.y }));
+        layer.sprite = std::make_unique<sf::Sprite>(layer.target->getTexture());
+        layer.sprite->setScale(sceneSize.x / static_cast<float>(size.x), sceneSize.y / static_cast<float>(size.y));
+        layer.bDirty = true;
+    }
+
+    if(layer.bDirty)
+    {
+        layer.target->clear(sf::Color::Transparent);
+        for(auto it = first; it != last; ++it)
+        {
+            if(!(*it)->isPendingToRemove()) (*it)->draw(*layer.target, states);
+        }
+        layer.target->display();
+        layer.bDirty = false;
+
+        // RenderThread samples the layer from its own context, it must be complete
+        glFinish();
+    }
+
+    // Blending into a transparent target leaves colors premultiplied by alpha
+    sf::RenderStates layerStates = states;
+    layerStates.blendMode = sf::BlendMode(sf::BlendMode::One, sf::BlendMode::OneMinusSrcAlpha);
+    queue_.submit(*layer.sprite, layerStates, (*first)->getSceneNodeID());
+    return true;
+}
 
-    // Then, draw all of them
+void Scene::cull(const sf::FloatRect& view) const
+{
+    size_t bounded = 0;
     for(auto const& node : nodes_)
     {
-        node->draw(target, states);
+        if(node->updateGlobalBounds()) bGridDirty_ = true;
+        if(node->localBounds_) bounded++;
     }
 
-    // Restore original view
-    target.setView(originalView);
+    if(bounded < GRID_MIN_NODES)
+    {
+        for(auto const& node : nodes_)
+        {
+            node->bVisible_ = !node->localBounds_ || node->globalBounds_.intersects(view);
+        }
+    }
+    else
+    {
+        if(bGridDirty_)
+        {
+            grid_.clear();
+            gridNodes_.clear();
+            for(auto const& node : nodes_)
+            {
+                if(!node->localBounds_) continue;
+
+                grid_.insert(static_cast<uint32_t>(gridNodes_.size()), node->globalBounds_);
+                gridNodes_.push_back(node.get());
+            }
+            bGridDirty_ = false;
+        }
+
+        // Bounded nodes are hidden unless a cell touching the view has them
+        for(auto const& node : nodes_)
+        {
+            node->bVisible_ = !node->localBounds_;
+        }
+
+        grid_.query(view, gridResults_);
+        for(const auto id : gridResults_)
+        {
+            const auto* node = gridNodes_[id];
+            node->bVisible_ = node->globalBounds_.intersects(view);
+        }
+    }
+
+    culledNodes_ = static_cast<size_t>(std::ranges::count_if(nodes_, [](auto& node){ return !node->bVisible_; }));
 }
 
 class SceneNode* Scene::addSceneNode_Internal(SceneNodePtr node)
 {
     node->setSceneOwner(this);
     node->init();
+    invalidateGroup(node->getSceneNodeID().group);
+    bGridDirty_ = true;
     return nodes_.emplace_back(std::move(node)).get();
 }
 
+void Scene::removeSceneNode(SceneNode& node)
+{
+    assert(node.owner_ == this && "Removing a SceneNode from a scene that doesn't own it");
+
+    if(node.bPendingToRemove_) return;
+
+    node.bPendingToRemove_ = true;
+    ++pendingRemovals_;
+    invalidateGroup(node.getSceneNodeID().group);
+}
+
+void Scene::flushRemovals()
+{
+    if(pendingRemovals_ == 0) return;
+
+    for(auto it = nodes_.begin(); it != nodes_.end();)
+    {
+        const auto node = it++;
+        if(!(*node)->isPendingToRemove()) continue;
+
+        // Last recording may still draw textures of the node, it's deleted on next record
+        (*node)->destroy();
+        removedNodes_.splice(removedNodes_.end(), nodes_, node);
+    }
+    pendingRemovals_ = 0;
+    bGridDirty_ = true;
+}
+
 sf::Vector2i Scene::getSceneMousePos() const
 {
     auto pos = AspectRatio::transformPointToTextureCoords(
@@ -96,6 +279,11 @@ sf::Vector2i Scene::getSceneMousePos() const
     else return {0, 0};
 }
 
+sf::FloatRect Scene::getViewArea()
+{
+    return { 0.f, 0.f, Configuration::BACKGROUND_TEX_SIZE_X, Configuration::BACKGROUND_TEX_SIZE_Y };
+}
+
 void Scene::destroy()
 {
     bPendingToDestroy_ = true;
@@ -106,6 +294,30 @@ void Scene::destroy()
     }
 }
 
+void Scene::resize()
+{
+    for(auto& [group, layer] : staticLayers_)
+    {
+        layer.bDirty = true;
+    }
+
+    for(auto const& node : nodes_)
+    {
+        if(!node->isPendingToRemove()) node->resize();
+    }
+}
+
+void Scene::setGroupStatic(SceneNode::groupType group, bool bStatic)
+{
+    if(bStatic) staticLayers_.try_emplace(group);
+    else staticLayers_.erase(group);
+}
+
+void Scene::invalidateGroup(SceneNode::groupType group)
+{
+    if(auto layer = staticLayers_.find(group); layer != staticLayers_.end()) layer->second.bDirty = true;
+}
+
 bool Scene::isPendingToDestroy() const
 {
     return bPendingToDestroy_;
@@ -23,13 +23,25 @@
 
 #include <memory>
 #include <list>
+#include <map>
+#include <vector>
 
 #include <SFML/Graphics/Drawable.hpp>
 
+#include <scene/CullingGrid.hpp>
+#include <scene/RenderQueue.hpp>
+#include <scene/SceneNode.hpp>
+
+namespace sf
+{
+    class RenderTexture;
+    class Sprite;
+    class Texture;
+}
+
 namespace lpm
 {
     class Engine;
-    class SceneNode;
 
     /**
      * @brief Represent the current whole of elements to be draw by Engine.
@@ -50,12 +62,26 @@ namespace lpm
      * If NodeA lies in Group 1 and internal 1, and NodeB lies in Group2 and internal 0, then NodeA are drawn BEFORE
      * NodeB, regardless NodeB has lower internal value than NodeA.
      *
+     * Nodes don't draw right away, they submit their drawables into a RenderQueue that sorts them by group, depth,
+     * shader and texture before drawing.
+     *
+     * Nodes with bounds (SceneNode::setLocalBounds) outside the view are culled before they are submitted. Past
+     * GRID_MIN_NODES of them, candidates come from a CullingGrid that is only rebuilt when nodes move.
+     *
+     * Groups that rarely change, as backgrounds, can be flagged static. They are drawn once into a cached target and
+     * that target is drawn every frame instead, until a node of the group changes or the window is resized.
+     *
+     * A recording only holds handles to textures, and it may be drawn by a RenderThread while nodes tick. Textures
+     * nodes stop using go through retire() and are freed on the next record, once that frame was drawn.
      */
     class Scene : public sf::Drawable
     {
         using SceneNodePtr  = std::unique_ptr<class SceneNode>;
         using SceneNodesPtr = std::list<SceneNodePtr>;
 
+    public:
+        static constexpr size_t GRID_MIN_NODES = 64;   //< Bounded nodes from which culling uses the grid
+
     public:
         explicit Scene(Engine* engine);
         ~Scene() override;
@@ -77,8 +103,49 @@ namespace lpm
             return *static_cast<SceneNodeType*>(node);
         }
 
+        /**
+         * @brief Remove SceneNode from Scene and delete it.
+         *
+         * Removal is deferred until the end of the current tick, so it's safe to remove any node, even itself,
+         * while ticking or drawing. Removed nodes are no longer ticked nor drawn, and they are deleted on the next
+         * record, once the frame recorded before was drawn.
+         */
+        void removeSceneNode(SceneNode& node);
+
         void destroy();
 
+        /**
+         * Tell every SceneNode the window was resized
+         */
+        void resize();
+
+        /**
+         * Draw group through a cached target, redrawn only when invalidated.
+         * Nodes of static groups must call SceneNode::invalidate when they look different.
+         */
+        void setGroupStatic(SceneNode::groupType group, bool bStatic = true);
+
+        /**
+         * Redraw cached target of group next frame, if it's static
+         */
+        void invalidateGroup(SceneNode::groupType group);
+
+        /**
+         * Free texture once the frame recorded before it stopped being used is drawn
+         */
+        void retire(std::unique_ptr<sf::Texture> texture);
+
+        /**
+         * Cull and queue copies of what nodes draw for a target of targetSize. Static groups are redrawn here if needed.
+         * Drawing is split in record and execute so a render thread can execute while the scene ticks.
+         */
+        void record(sf::Vector2u targetSize, const sf::RenderStates& states = sf::RenderStates::Default) const;
+
+        /**
+         * Draw what was last recorded, only the recording is read
+         */
+        void execute(sf::RenderTarget& target) const;
+
     public:
         /**
          * Get mouse coords transformed to aspect ratio used in the scene
@@ -86,6 +153,11 @@ namespace lpm
          */
         [[nodiscard]] sf::Vector2i getSceneMousePos() const;
 
+        /**
+         * Get area of scene units shown in the window
+         */
+        [[nodiscard]] static sf::FloatRect getViewArea();
+
         /**
          * Get pointer to engine
          * @return Engine pointer
@@ -98,17 +170,63 @@ namespace lpm
          */
         [[nodiscard]] bool isPendingToDestroy() const;
 
+        /**
+         * Get draw calls and state changes of last frame recorded
+         */
+        [[nodiscard]] const RenderQueue::Stats& getRenderStats() const { return queue_.getStats(); }
+
+        /**
+         * Get nodes skipped last frame for being outside the view
+         */
+        [[nodiscard]] size_t getCulledCount() const { return culledNodes_; }
+
 
     protected:
         void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
 
     private:
+        struct StaticLayer
+        {
+            std::unique_ptr<sf::RenderTexture> target;
+            std::unique_ptr<sf::Sprite> sprite;
+            bool bDirty = true;
+        };
+
         SceneNode* addSceneNode_Internal(SceneNodePtr node);
 
+        /**
+         * Flag nodes visible if they have no bounds or their bounds touch view
+         */
+        void cull(const sf::FloatRect& view) const;
+
+        /**
+         * Submit cached target of a static group, redrawing it if needed
+         * @return False if target can't be created, nodes must be submitted directly
+         */
+        bool submitStaticLayer(StaticLayer& layer, SceneNodesPtr::const_iterator first, SceneNodesPtr::const_iterator last,
+                               sf::Vector2u targetSize, const sf::RenderStates& states) const;
+
+        /**
+         * Take nodes queued by removeSceneNode out of the scene
+         */
+        void flushRemovals();
+
     private:
         Engine* const engine_   = nullptr;
         bool bPendingToDestroy_ = false;
 
         mutable SceneNodesPtr nodes_;
+        size_t pendingRemovals_ = 0;
+
+        mutable std::map<SceneNode::groupType, StaticLayer> staticLayers_;     //< Cached targets of static groups
+        mutable RenderQueue queue_;
+        mutable std::vector<std::unique_ptr<sf::Texture>> retired_;      //< Textures last recording may still draw
+        mutable SceneNodesPtr removedNodes_;                                //< Destroyed nodes last recording may still draw
+
+        mutable CullingGrid grid_;
+        mutable std::vector<const SceneNode*> gridNodes_;   //< Node of every grid id
+        mutable std::vector<uint32_t> gridResults_;
+        mutable bool bGridDirty_ = true;                    //< Nodes were added, removed or moved
+        mutable size_t culledNodes_ = 0;
     };
 }
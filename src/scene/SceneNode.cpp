@@ -21,6 +21,7 @@
 
 #include "SceneNode.hpp"
 
+#include <algorithm>
 #include <cassert>
 
 #include <scene/Scene.hpp>
@@ -72,11 +73,47 @@ SceneNode& SceneNode::setName(std::string_view name)
 
 SceneNode& SceneNode::setDrawOrder(groupType group, depthType depth/*= 0*/)
 {
+    // Node leaves one group and joins another
+    invalidate();
     id_.group = group;
     id_.depth = depth;
+    invalidate();
     return *this;
 }
 
+void SceneNode::invalidate()
+{
+    if(owner_) owner_->invalidateGroup(id_.group);
+}
+
+std::optional<sf::FloatRect> SceneNode::getGlobalBounds() const
+{
+    if(!localBounds_) return {};
+
+    updateGlobalBounds();
+    return globalBounds_;
+}
+
+void SceneNode::setLocalBounds(const sf::FloatRect& bounds)
+{
+    localBounds_ = bounds;
+    bBoundsDirty_ = true;
+}
+
+bool SceneNode::updateGlobalBounds() const
+{
+    if(!localBounds_) return false;
+
+    // Transformable keeps its transform cached, comparing it is cheaper than transforming bounds
+    const auto& transform = getTransform();
+    if(!bBoundsDirty_ && std::equal(transform.getMatrix(), transform.getMatrix() + 16, boundsTransform_.getMatrix())) return false;
+
+    globalBounds_ = transform.transformRect(*localBounds_);
+    boundsTransform_ = transform;
+    bBoundsDirty_ = false;
+    return true;
+}
+
 void SceneNode::generateAutomaticNodeName()
 {
     static size_t counter = std::numeric_limits<size_t>::max();
@@ -23,14 +23,17 @@
 
 #include <string>
 #include <limits>
+#include <optional>
 
 #include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/Rect.hpp>
 #include <SFML/Graphics/Transformable.hpp>
 
 
 namespace lpm
 {
     class Scene;
+    class RenderQueue;
 
     /**
      * @brief Child element of a lpm::Scene.
@@ -67,14 +70,58 @@ namespace lpm
         SceneNode& setName(std::string_view name);
         SceneNode& setDrawOrder(groupType group, depthType depth = {});
 
+        /**
+         * Check if this node was removed with Scene::removeSceneNode and waits to be deleted
+         */
+        [[nodiscard]] bool isPendingToRemove() const { return bPendingToRemove_; }
+
+        /**
+         * Get area drawn by this node in scene units, with its transform applied
+         * @return Empty if node didn't set local bounds, it's never culled then
+         */
+        [[nodiscard]] std::optional<sf::FloatRect> getGlobalBounds() const;
+
     private:
         void generateAutomaticNodeName();
 
+        /**
+         * Recompute cached global bounds if local bounds or transform changed
+         * @return True if they changed
+         */
+        bool updateGlobalBounds() const;
+
     protected:
         virtual void init() {};
         virtual void tick(float /*deltaTime*/) {};
         virtual void destroy() {};
 
+        /**
+         * Window was resized, scene keeps its units but is drawn bigger or smaller
+         */
+        virtual void resize() {};
+
+        /**
+         * Tell scene this node looks different, needed to redraw static groups
+         */
+        void invalidate();
+
+        /**
+         * Called every frame before culling, while no recorded frame is being drawn. Work that changes resources the
+         * render thread reads, as loading glyphs into a font, goes here instead of tick.
+         */
+        virtual void prepare() {};
+
+        /**
+         * Queue copies of what this node draws, so they are sorted by texture and shader. The render thread draws
+         * them while the node keeps ticking.
+         */
+        virtual void submit(RenderQueue& queue, const sf::RenderStates& states) const = 0;
+
+        /**
+         * Set area drawn by this node, before its transform. Scene skips nodes outside the view.
+         */
+        void setLocalBounds(const sf::FloatRect& bounds);
+
     protected:
         Scene* getSceneOwner() const;
         std::string getName() const;
@@ -85,6 +132,13 @@ namespace lpm
         Scene* owner_ = nullptr;
         std::string name_;
         SceneNodeID id_;
+        bool bPendingToRemove_ = false;
+
+        std::optional<sf::FloatRect> localBounds_;
+        mutable sf::FloatRect globalBounds_;
+        mutable sf::Transform boundsTransform_;     //< Transform globalBounds_ was computed with
+        mutable bool bBoundsDirty_ = true;
+        mutable bool bVisible_ = true;              //< Inside view last frame, set by Scene
     };
 
     struct CommonDepths
@@ -21,24 +21,114 @@
 
 #include "BackgroundNode.hpp"
 
+#include <iostream>
+
+#include <SFML/Graphics/Image.hpp>
 #include <SFML/Graphics/Sprite.hpp>
 #include <SFML/Graphics/Texture.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 
+#include <components/AssetTiers.hpp>
+#include <components/TextureCache.hpp>
+#include <scene/RenderQueue.hpp>
+#include <scene/Scene.hpp>
+#include <Engine.hpp>
+
 using namespace lpm;
 
 BackgroundNode::BackgroundNode(std::string_view textureName)
-: texture_(std::make_unique<sf::Texture>())
+: textureName_(textureName)
 , sprite_(std::make_unique<sf::Sprite>())
 {
-    texture_->loadFromFile(textureName.data());
-    sprite_->setTexture(*texture_);
 }
 
 BackgroundNode::~BackgroundNode() = default;
 
+void BackgroundNode::init()
+{
+    const auto* engine = getSceneOwner()->getEngine();
+    const auto tier = engine->getTiers().select(textureName_, engine->getViewportScale());
+
+    // First tier is loaded right away, scene can't be shown without it
+    auto texture = std::make_unique<sf::Texture>();
+    if(!TextureCache::loadTexture(tier.file, *texture))
+    {
+        // A missing variant shouldn't leave the scene without background
+        if(tier.file == textureName_ || !TextureCache::loadTexture(textureName_, *texture)) return;
+        setTexture(std::move(texture), 1.f);
+        shownFile_ = textureName_;
+        return;
+    }
+
+    setTexture(std::move(texture), tier.scale);
+    shownFile_ = tier.file;
+}
+
+void BackgroundNode::tick(float /*deltaTime*/)
+{
+    if(batch_ == 0) return;
+
+    auto& loader = getSceneOwner()->getEngine()->getLoader();
+    results_.clear();
+    if(loader.collect(batch_, results_) == 0) return;
+
+    batch_ = 0;
+    auto& result = results_.front();
+
+    if(auto texture = std::make_unique<sf::Texture>(); result.bLoaded && texture->loadFromImage(*result.image))
+    {
+        setTexture(std::move(texture), pendingScale_);
+        shownFile_ = std::move(pendingFile_);
+    }
+    else
+    {
+        std::cerr << "Can't load background tier \042" << result.fileName << "\042\n";
+    }
+}
+
+void BackgroundNode::resize()
+{
+    const auto* engine = getSceneOwner()->getEngine();
+    const auto tier = engine->getTiers().select(textureName_, engine->getViewportScale());
+    if(tier.file == (batch_ != 0 ? pendingFile_ : shownFile_)) return;
+
+    auto& loader = getSceneOwner()->getEngine()->getLoader();
+    if(batch_ != 0) loader.cancel(batch_);
+    batch_ = 0;
+
+    // Resized back before the other tier arrived
+    if(tier.file == shownFile_) return;
+
+    // Current tier is drawn until the new one is ready
+    batch_ = loader.createBatch();
+    loader.load(tier.file, EAssetType::Image, batch_);
+    pendingFile_ = tier.file;
+    pendingScale_ = tier.scale;
+}
+
+void BackgroundNode::destroy()
+{
+    if(batch_ != 0) getSceneOwner()->getEngine()->getLoader().cancel(batch_);
+    batch_ = 0;
+}
+
+void BackgroundNode::setTexture(std::unique_ptr<sf::Texture> texture, float scale)
+{
+    // Tier being replaced may be drawn by the render thread right now
+    getSceneOwner()->retire(std::move(texture_));
+    texture_ = std::move(texture);
+    sprite_->setTexture(*texture_, true);
+    sprite_->setScale(1.f / scale, 1.f / scale);
+    setLocalBounds(sprite_->getGlobalBounds());
+    invalidate();
+}
 
 void BackgroundNode::draw(sf::RenderTarget& target, sf::RenderStates states) const
 {
-    target.draw(*sprite_, states);
+    if(texture_) target.draw(*sprite_, states);
+}
+
+void BackgroundNode::submit(RenderQueue& queue, const sf::RenderStates& states) const
+{
+    if(texture_) queue.submit(*sprite_, states, getSceneNodeID());
 }
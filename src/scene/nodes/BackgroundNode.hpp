@@ -22,8 +22,13 @@
 #pragma once
 
 #include <scene/SceneNode.hpp>
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <string_view>
+#include <vector>
+
+#include <components/AsyncLoader.hpp>
 
 namespace sf
 {
@@ -33,6 +38,13 @@ namespace sf
 
 namespace lpm
 {
+    /**
+     * @brief Full scene image, in the resolution tier that fits the window.
+     *
+     * The tier is picked from AssetTiers when the node starts and loaded right away. When the window is resized into
+     * another tier, the new one is decoded in the AsyncLoader and replaces the current texture when ready, so only
+     * one tier stays in memory.
+     */
     class BackgroundNode final : public SceneNode
     {
     public:
@@ -41,8 +53,25 @@ namespace lpm
 
         void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
 
+    protected:
+        void submit(RenderQueue& queue, const sf::RenderStates& states) const override;
+        void init() override;
+        void tick(float deltaTime) override;
+        void resize() override;
+        void destroy() override;
+
     private:
+        void setTexture(std::unique_ptr<sf::Texture> texture, float scale);
+
+    private:
+        std::string textureName_;
         std::unique_ptr<sf::Texture> texture_;
         std::unique_ptr<sf::Sprite> sprite_;
+
+        std::string shownFile_;                         //< File of tier shown
+        std::string pendingFile_;                       //< File of tier being loaded
+        float pendingScale_ = 1.f;
+        uint32_t batch_ = 0;                            //< Loader batch of tier being loaded, 0 if none
+        std::vector<AsyncLoader::Result> results_;
     };
 }
@@ -25,6 +25,7 @@
 #include <SFML/Window/Mouse.hpp>
 #include <SFML/Audio/Sound.hpp>
 
+#include <scene/RenderQueue.hpp>
 #include <scene/Scene.hpp>
 #include <Engine.hpp>
 
@@ -47,7 +48,7 @@ ClickableText::~ClickableText() = default;
 void ClickableText::setTextString(const sf::String& string)
 {
     text_->setString(string);
-    text_->setOrigin(text_->getGlobalBounds().width / 2.f, text_->getGlobalBounds().height / 2.f);
+    bLayoutDirty_ = true;
 }
 
 void ClickableText::init()
@@ -57,6 +58,7 @@ void ClickableText::init()
     if(auto font = resources.getFont("FontEntry"))
     {
         text_->setFont(**font);
+        bLayoutDirty_ = true;
     }
     else
     {
@@ -82,23 +84,39 @@ void ClickableText::init()
     }
 }
 
+void ClickableText::prepare()
+{
+    if(!bLayoutDirty_) return;
+
+    // Bounds load the glyphs of the string into the font, render thread may be reading it during tick
+    text_->setOrigin(text_->getGlobalBounds().width / 2.f, text_->getGlobalBounds().height / 2.f);
+    setLocalBounds(text_->getGlobalBounds());
+    bLayoutDirty_ = false;
+}
+
 void ClickableText::draw(sf::RenderTarget& target, sf::RenderStates states) const
 {
     states.transform *= getTransform();
     target.draw(*text_, states);
 }
 
+void ClickableText::submit(RenderQueue& queue, const sf::RenderStates& states) const
+{
+    sf::RenderStates textStates = states;
+    textStates.transform *= getTransform();
+    queue.submit(*text_, textStates, getSceneNodeID());
+}
+
 void ClickableText::tick(float deltaTime)
 {
     SceneNode::tick(deltaTime);
 
     const auto mousePos = getSceneOwner()->getSceneMousePos();
 
-    auto clickableGlobalRect = text_->getGlobalBounds();
-    clickableGlobalRect.left += getPosition().x;
-    clickableGlobalRect.top += getPosition().y;
+    // Laid out by prepare, text isn't clickable before its first frame
+    const auto clickableGlobalRect = getGlobalBounds();
 
-    if(clickableGlobalRect.contains((float)mousePos.x, (float)mousePos.y))
+    if(clickableGlobalRect && clickableGlobalRect->contains((float)mousePos.x, (float)mousePos.y))
     {
         text_->setFillColor(sf::Color::Yellow);
 
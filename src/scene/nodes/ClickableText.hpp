@@ -52,6 +52,8 @@ namespace lpm
 
     protected:
         void init() override;
+        void prepare() override;
+        void submit(RenderQueue& queue, const sf::RenderStates& states) const override;
 
     protected:
         void onMouseEnter() const;
@@ -63,6 +65,7 @@ namespace lpm
         std::unique_ptr<sf::Text> text_;
         std::unique_ptr<sf::Sound> soundHover_;
         std::unique_ptr<sf::Sound> soundClick_;
+        bool bLayoutDirty_ = false;                     //< Origin and bounds wait for prepare
 
         mutable bool bMouseEnter_     = false;
         mutable bool bMouseClickDown_ = false;
@@ -0,0 +1,78 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "ShaderNode.hpp"
+
+#include <SFML/Graphics/RectangleShape.hpp>
+#include <SFML/Graphics/RenderStates.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Shader.hpp>
+
+#include <components/Material.hpp>
+#include <scene/RenderQueue.hpp>
+#include <Configuration.hpp>
+
+using namespace lpm;
+
+ShaderNode::ShaderNode()
+: shader_(std::make_unique<sf::Shader>())
+, quad_(std::make_unique<sf::RectangleShape>())
+, material_(std::make_unique<Material>(*shader_))
+{
+    quad_->setSize({Configuration::BACKGROUND_TEX_SIZE_X, Configuration::BACKGROUND_TEX_SIZE_Y});
+    quad_->setPosition(0, 0);
+}
+
+ShaderNode::~ShaderNode() = default;
+
+bool ShaderNode::loadFragmentShader(std::string_view fileName)
+{
+    return shader_->loadFromFile(std::string(fileName), sf::Shader::Fragment);
+}
+
+void ShaderNode::setSize(sf::Vector2f size)
+{
+    quad_->setSize(size);
+}
+
+void ShaderNode::setQuadTexture(const sf::Texture* texture)
+{
+    quad_->setTexture(texture);
+}
+
+void ShaderNode::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+    material_->record();
+    material_->apply();
+
+    states.shader = shader_.get();
+    target.draw(*quad_, states);
+}
+
+void ShaderNode::submit(RenderQueue& queue, const sf::RenderStates& states) const
+{
+    // Uniforms set while the frame is drawn wait for the next recording
+    material_->record();
+
+    sf::RenderStates quadStates = states;
+    quadStates.shader = shader_.get();
+    queue.submit(*quad_, quadStates, getSceneNodeID(), 0, material_.get());
+}
@@ -0,0 +1,80 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <scene/SceneNode.hpp>
+#include <memory>
+#include <string_view>
+
+#include <SFML/System/Vector2.hpp>
+
+namespace sf
+{
+    class Shader;
+    class Texture;
+    class RectangleShape;
+}
+
+namespace lpm
+{
+    class Material;
+
+    /**
+     * @brief Quad drawn with a fragment shader, the base of shader driven effects.
+     *
+     * Uniforms go through the Material: register them once after loading the shader, set them whenever, and only
+     * those that changed are uploaded, once per draw. Values are taken when the node is recorded, so a render thread
+     * drawing the last frame doesn't see uniforms set meanwhile. The quad covers the whole scene unless resized.
+     */
+    class ShaderNode : public SceneNode
+    {
+    public:
+        ShaderNode();
+        ~ShaderNode() override;
+
+    public:
+        /**
+         * Load fragment shader
+         * @return False if shader can't be read or compiled
+         */
+        bool loadFragmentShader(std::string_view fileName);
+
+        void setSize(sf::Vector2f size);
+
+        /**
+         * Set texture that gives its coordinates to the quad, shaders sampling other textures use the same ones
+         */
+        void setQuadTexture(const sf::Texture* texture);
+
+        [[nodiscard]] Material& getMaterial() { return *material_; }
+
+        void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+    protected:
+        void submit(RenderQueue& queue, const sf::RenderStates& states) const override;
+
+    private:
+        std::unique_ptr<sf::Shader> shader_;
+        std::unique_ptr<sf::RectangleShape> quad_;
+        std::unique_ptr<Material> material_;
+    };
+}
@@ -23,6 +23,7 @@
 
 #include <SFML/Graphics/Text.hpp>
 
+#include <scene/RenderQueue.hpp>
 #include <scene/Scene.hpp>
 #include <Engine.hpp>
 #include <Resources.hpp>
@@ -42,7 +43,7 @@ Text::~Text() = default;
 void Text::setTextString(const sf::String& string)
 {
     text_->setString(string);
-    text_->setOrigin(text_->getGlobalBounds().width / 2.f, text_->getGlobalBounds().height / 2.f);
+    bLayoutDirty_ = true;
 }
 
 void Text::setTextFillColor(const sf::Color& color)
@@ -58,6 +59,7 @@ void Text::init()
     {
         text_->setFont(**font);
         text_->setCharacterSize(fontSize_);
+        bLayoutDirty_ = true;
     }
     else
     {
@@ -65,8 +67,25 @@ void Text::init()
     }
 }
 
+void Text::prepare()
+{
+    if(!bLayoutDirty_) return;
+
+    // Bounds load the glyphs of the string into the font, render thread may be reading it during tick
+    text_->setOrigin(text_->getGlobalBounds().width / 2.f, text_->getGlobalBounds().height / 2.f);
+    setLocalBounds(text_->getGlobalBounds());
+    bLayoutDirty_ = false;
+}
+
 void Text::draw(sf::RenderTarget& target, sf::RenderStates states) const
 {
     states.transform *= getTransform();
     target.draw(*text_, states);
 }
+
+void Text::submit(RenderQueue& queue, const sf::RenderStates& states) const
+{
+    sf::RenderStates textStates = states;
+    textStates.transform *= getTransform();
+    queue.submit(*text_, textStates, getSceneNodeID());
+}
@@ -51,11 +51,14 @@ namespace lpm
 
     protected:
         void init() override;
+        void prepare() override;
+        void submit(RenderQueue& queue, const sf::RenderStates& states) const override;
 
 
     private:
         std::unique_ptr<sf::Text> text_;
         std::string fontName_;
         unsigned fontSize_;
+        bool bLayoutDirty_ = false;                     //< Origin and bounds wait for prepare
     };
 }
@@ -35,6 +35,8 @@ using namespace lpm;
 
 LoginScene::LoginScene(class Engine* engine) : Scene(engine)
 {
+    setGroupStatic(CommonDepths::BACKGROUND);
+
     addSceneNode<BackgroundNode>("loginScreen.png")
     .setName("Background")
     .setDrawOrder(CommonDepths::BACKGROUND);
@@ -0,0 +1,431 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "SplashCompositor.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <string_view>
+
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/OpenGL.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define LPM_SPLASH_SSE2
+    #include <immintrin.h>
+
+    // GCC and Clang build the AVX2 kernel for the target and choose it at runtime, others only if enabled
+    #if defined(__AVX2__)
+        #define LPM_SPLASH_AVX2
+        #define LPM_SPLASH_AVX2_TARGET
+    #elif defined(__GNUC__)
+        #define LPM_SPLASH_AVX2
+        #define LPM_SPLASH_AVX2_TARGET __attribute__((target("avx2")))
+    #endif
+#elif defined(__ARM_NEON)
+    #define LPM_SPLASH_NEON
+    #include <arm_neon.h>
+#endif
+
+using namespace lpm;
+
+namespace
+{
+    /**
+     * Contiguous span of a row. Every layer pointer is already scrolled and bytes never cross its wrap.
+     */
+    struct RowInput
+    {
+        std::array<const uint8_t*, SplashCompositor::LAYERS> layers;
+        std::array<const uint8_t*, SplashCompositor::LAYERS> weights;
+        std::array<uint16_t, SplashCompositor::LAYERS> intensities;    //< 0 to 255
+        const uint8_t* top;
+        uint8_t* out;
+        size_t bytes;
+    };
+
+    using RowKernel = void(*)(const RowInput& row, size_t first);
+
+    /**
+     * Reference of every kernel: out = min(sum(texel * weight * intensity), 1) * top, with products rounded up
+     */
+    void blendScalar(const RowInput& row, size_t first)
+    {
+        for(size_t b = first; b < row.bytes; b++)
+        {
+            unsigned accumulated = 0;
+            for(size_t i = 0; i < SplashCompositor::LAYERS; i++)
+            {
+                const unsigned weight = (row.weights[i][b] * row.intensities[i] + 255u) >> 8;
+                accumulated += (row.layers[i][b] * weight + 255u) >> 8;
+            }
+
+            accumulated = std::min(accumulated, 255u);
+            row.out[b] = static_cast<uint8_t>((accumulated * row.top[b] + 255u) >> 8);
+        }
+    }
+
+#ifdef LPM_SPLASH_SSE2
+    void blendSSE2(const RowInput& row, size_t first)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i bias = _mm_set1_epi16(255);
+
+        size_t b = first;
+        for(; b + 16 <= row.bytes; b += 16)
+        {
+            __m128i accumulatedLo = zero;
+            __m128i accumulatedHi = zero;
+
+            for(size_t i = 0; i < SplashCompositor::LAYERS; i++)
+            {
+                const __m128i intensity = _mm_set1_epi16(static_cast<short>(row.intensities[i]));
+                const __m128i texels  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row.layers[i] + b));
+                const __m128i weights = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row.weights[i] + b));
+
+                const __m128i weightLo = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(weights, zero), intensity), bias), 8);
+                const __m128i weightHi = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(weights, zero), intensity), bias), 8);
+
+                accumulatedLo = _mm_add_epi16(accumulatedLo, _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(texels, zero), weightLo), bias), 8));
+                accumulatedHi = _mm_add_epi16(accumulatedHi, _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(texels, zero), weightHi), bias), 8));
+            }
+
+            const __m128i top = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row.top + b));
+            accumulatedLo = _mm_min_epi16(accumulatedLo, bias);
+            accumulatedHi = _mm_min_epi16(accumulatedHi, bias);
+
+            const __m128i outLo = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(accumulatedLo, _mm_unpacklo_epi8(top, zero)), bias), 8);
+            const __m128i outHi = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(accumulatedHi, _mm_unpackhi_epi8(top, zero)), bias), 8);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(row.out + b), _mm_packus_epi16(outLo, outHi));
+        }
+
+        blendScalar(row, b);
+    }
+#endif
+
+#ifdef LPM_SPLASH_AVX2
+    LPM_SPLASH_AVX2_TARGET void blendAVX2(const RowInput& row, size_t first)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i bias = _mm256_set1_epi16(255);
+
+        // Unpack and pack work inside 128 bit lanes, so bytes come back in order
+        size_t b = first;
+        for(; b + 32 <= row.bytes; b += 32)
+        {
+            __m256i accumulatedLo = zero;
+            __m256i accumulatedHi = zero;
+
+            for(size_t i = 0; i < SplashCompositor::LAYERS; i++)
+            {
+                const __m256i intensity = _mm256_set1_epi16(static_cast<short>(row.intensities[i]));
+                const __m256i texels  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row.layers[i] + b));
+                const __m256i weights = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row.weights[i] + b));
+
+                const __m256i weightLo = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(weights, zero), intensity), bias), 8);
+                const __m256i weightHi = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(weights, zero), intensity), bias), 8);
+
+                accumulatedLo = _mm256_add_epi16(accumulatedLo, _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(texels, zero), weightLo), bias), 8));
+                accumulatedHi = _mm256_add_epi16(accumulatedHi, _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(texels, zero), weightHi), bias), 8));
+            }
+
+            const __m256i top = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row.top + b));
+            accumulatedLo = _mm256_min_epi16(accumulatedLo, bias);
+            accumulatedHi = _mm256_min_epi16(accumulatedHi, bias);
+
+            const __m256i outLo = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(accumulatedLo, _mm256_unpacklo_epi8(top, zero)), bias), 8);
+            const __m256i outHi = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(accumulatedHi, _mm256_unpackhi_epi8(top, zero)), bias), 8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(row.out + b), _mm256_packus_epi16(outLo, outHi));
+        }
+
+        blendScalar(row, b);
+    }
+#endif
+
+#ifdef LPM_SPLASH_NEON
+    void blendNEON(const RowInput& row, size_t first)
+    {
+        const uint16x8_t bias = vdupq_n_u16(255);
+
+        size_t b = first;
+        for(; b + 16 <= row.bytes; b += 16)
+        {
+            uint16x8_t accumulatedLo = vdupq_n_u16(0);
+            uint16x8_t accumulatedHi = vdupq_n_u16(0);
+
+            for(size_t i = 0; i < SplashCompositor::LAYERS; i++)
+            {
+                const uint16x8_t intensity = vdupq_n_u16(row.intensities[i]);
+                const uint8x16_t texels  = vld1q_u8(row.layers[i] + b);
+                const uint8x16_t weights = vld1q_u8(row.weights[i] + b);
+
+                const uint16x8_t weightLo = vshrq_n_u16(vaddq_u16(vmulq_u16(vmovl_u8(vget_low_u8(weights)), intensity), bias), 8);
+                const uint16x8_t weightHi = vshrq_n_u16(vaddq_u16(vmulq_u16(vmovl_u8(vget_high_u8(weights)), intensity), bias), 8);
+
+                accumulatedLo = vaddq_u16(accumulatedLo, vshrq_n_u16(vaddq_u16(vmulq_u16(vmovl_u8(vget_low_u8(texels)), weightLo), bias), 8));
+                accumulatedHi = vaddq_u16(accumulatedHi, vshrq_n_u16(vaddq_u16(vmulq_u16(vmovl_u8(vget_high_u8(texels)), weightHi), bias), 8));
+            }
+
+            const uint8x16_t top = vld1q_u8(row.top + b);
+            accumulatedLo = vminq_u16(accumulatedLo, bias);
+            accumulatedHi = vminq_u16(accumulatedHi, bias);
+
+            const uint16x8_t outLo = vshrq_n_u16(vaddq_u16(vmulq_u16(accumulatedLo, vmovl_u8(vget_low_u8(top))), bias), 8);
+            const uint16x8_t outHi = vshrq_n_u16(vaddq_u16(vmulq_u16(accumulatedHi, vmovl_u8(vget_high_u8(top))), bias), 8);
+            vst1q_u8(row.out + b, vcombine_u8(vmovn_u16(outLo), vmovn_u16(outHi)));
+        }
+
+        blendScalar(row, b);
+    }
+#endif
+
+    RowKernel getRowKernel(SplashCompositor::EKernel kernel)
+    {
+        switch(kernel)
+        {
+#ifdef LPM_SPLASH_SSE2
+            case SplashCompositor::EKernel::SSE2: return &blendSSE2;
+#endif
+#ifdef LPM_SPLASH_AVX2
+            case SplashCompositor::EKernel::AVX2: return &blendAVX2;
+#endif
+#ifdef LPM_SPLASH_NEON
+            case SplashCompositor::EKernel::NEON: return &blendNEON;
+#endif
+            default: return &blendScalar;
+        }
+    }
+
+    /**
+     * Copy image as RGBA at scene resolution, nearest pixel if it has another size
+     */
+    std::vector<uint8_t> toScenePixels(const sf::Image& image)
+    {
+        constexpr auto WIDTH = SplashCompositor::WIDTH;
+        constexpr auto HEIGHT = SplashCompositor::HEIGHT;
+
+        std::vector<uint8_t> pixels(static_cast<size_t>(WIDTH) * HEIGHT * 4, 0);
+
+        const auto size = image.getSize();
+        const auto* source = image.getPixelsPtr();
+        if(size.x == 0 || size.y == 0 || !source) return pixels;
+
+        for(unsigned y = 0; y < HEIGHT; y++)
+        {
+            const auto* sourceRow = source + static_cast<size_t>(y * size.y / HEIGHT) * size.x * 4;
+            for(unsigned x = 0; x < WIDTH; x++)
+            {
+                std::copy_n(sourceRow + static_cast<size_t>(x * size.x / WIDTH) * 4, 4, &pixels[(static_cast<size_t>(y) * WIDTH + x) * 4]);
+            }
+        }
+
+        return pixels;
+    }
+}
+
+SplashCompositor::SplashCompositor(const sf::Image& mask, const sf::Image& topMask)
+: kernel_(getKernel())
+{
+    const auto maskPixels = toScenePixels(mask);
+    const auto topPixels = toScenePixels(topMask);
+    const size_t bytes = maskPixels.size();
+
+    for(auto& weights : weights_) weights.resize(bytes);
+    top_.resize(bytes);
+
+    // Same weights as splash.frag, repeated on every channel so kernels read them like texels
+    for(size_t p = 0; p < bytes; p += 4)
+    {
+        const unsigned r = maskPixels[p], g = maskPixels[p + 1], b = maskPixels[p + 2], a = maskPixels[p + 3];
+        const std::array<uint8_t, LAYERS> weights = {
+            static_cast<uint8_t>(r * a / 255),
+            static_cast<uint8_t>(g * a / 255),
+            static_cast<uint8_t>(b * a / 255),
+            static_cast<uint8_t>(255 - a)
+        };
+
+        for(size_t i = 0; i < LAYERS; i++) std::fill_n(&weights_[i][p], 4, weights[i]);
+        std::fill_n(&top_[p], 4, topPixels[p]);
+    }
+
+    for(auto& layer : layers_) layer.assign(bytes, 0);
+    for(auto& buffer : buffers_) buffer.assign(bytes, 0);
+
+    worker_ = std::thread(&SplashCompositor::work, this);
+}
+
+SplashCompositor::~SplashCompositor()
+{
+    {
+        std::scoped_lock lock(mutex_);
+        bStop_ = true;
+    }
+    wakeUp_.notify_one();
+    worker_.join();
+}
+
+void SplashCompositor::setLayer(size_t index, const sf::Image& image)
+{
+    backLayers_[index] = toScenePixels(image);
+}
+
+void SplashCompositor::swapLayer(size_t index)
+{
+    if(backLayers_[index].empty()) return;
+
+    std::scoped_lock lock(layersMutex_);
+    std::swap(layers_[index], backLayers_[index]);
+}
+
+void SplashCompositor::request(const Frame& frame)
+{
+    {
+        std::scoped_lock lock(mutex_);
+        requested_ = frame;
+        bRequested_ = true;
+    }
+    wakeUp_.notify_one();
+}
+
+bool SplashCompositor::collect(sf::Texture& texture)
+{
+    {
+        std::scoped_lock lock(mutex_);
+        if(!bFresh_) return false;
+
+        std::swap(ready_, upload_);
+        bFresh_ = false;
+    }
+
+    texture.update(buffers_[upload_].data());
+    return true;
+}
+
+void SplashCompositor::compose(const Frame& frame, uint8_t* pixels, EKernel kernel)
+{
+    const RowKernel blend = getRowKernel(kernel);
+
+    // Whole pixels each layer is scrolled, as ping_pong() of splash.frag
+    std::array<unsigned, LAYERS> shifts;
+    RowInput row;
+    for(size_t i = 0; i < LAYERS; i++)
+    {
+        const auto& displacement = frame.displacements[i];
+        const float offset = displacement.x + std::abs(std::sin(frame.time * displacement.z)) * displacement.y;
+        const long shift = std::lround(offset * WIDTH) % static_cast<long>(WIDTH);
+
+        shifts[i] = static_cast<unsigned>(shift < 0 ? shift + WIDTH : shift);
+        row.intensities[i] = static_cast<uint16_t>(std::lround(std::clamp(frame.intensities[i], 0.f, 1.f) * 255.f));
+    }
+
+    std::scoped_lock lock(layersMutex_);
+
+    for(size_t y = 0; y < HEIGHT; y++)
+    {
+        const size_t rowStart = y * WIDTH * 4;
+
+        // Split row where any layer wraps, so every span reads its layers contiguously
+        for(unsigned x = 0; x < WIDTH;)
+        {
+            unsigned end = WIDTH;
+            for(size_t i = 0; i < LAYERS; i++)
+            {
+                if(const unsigned wrap = WIDTH - shifts[i]; x < wrap) end = std::min(end, wrap);
+            }
+
+            for(size_t i = 0; i < LAYERS; i++)
+            {
+                row.layers[i] = layers_[i].data() + rowStart + static_cast<size_t>((x + shifts[i]) % WIDTH) * 4;
+                row.weights[i] = weights_[i].data() + rowStart + static_cast<size_t>(x) * 4;
+            }
+            row.top = top_.data() + rowStart + static_cast<size_t>(x) * 4;
+            row.out = pixels + rowStart + static_cast<size_t>(x) * 4;
+            row.bytes = static_cast<size_t>(end - x) * 4;
+
+            blend(row, 0);
+            x = end;
+        }
+    }
+}
+
+SplashCompositor::EKernel SplashCompositor::getKernel()
+{
+#if defined(LPM_SPLASH_AVX2) && defined(__AVX2__)
+    return EKernel::AVX2;
+#elif defined(LPM_SPLASH_AVX2)
+    if(__builtin_cpu_supports("avx2")) return EKernel::AVX2;
+    return EKernel::SSE2;
+#elif defined(LPM_SPLASH_SSE2)
+    return EKernel::SSE2;
+#elif defined(LPM_SPLASH_NEON)
+    return EKernel::NEON;
+#else
+    return EKernel::Scalar;
+#endif
+}
+
+const char* SplashCompositor::getKernelName(EKernel kernel)
+{
+    switch(kernel)
+    {
+        case EKernel::Scalar: return "Scalar";
+        case EKernel::SSE2:   return "SSE2";
+        case EKernel::AVX2:   return "AVX2";
+        case EKernel::NEON:   return "NEON";
+    }
+    return "Unknown";
+}
+
+bool SplashCompositor::isSoftwareRenderer()
+{
+    const auto* renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+    if(!renderer) return false;
+
+    const std::string_view name(renderer);
+    for(const std::string_view software : { "llvmpipe", "softpipe", "SwiftShader", "Software Rasterizer", "GDI Generic" })
+    {
+        if(name.find(software) != std::string_view::npos) return true;
+    }
+    return false;
+}
+
+void SplashCompositor::work()
+{
+    while(true)
+    {
+        Frame frame;
+        {
+            std::unique_lock lock(mutex_);
+            wakeUp_.wait(lock, [this](){ return bRequested_ || bStop_; });
+            if(bStop_) return;
+
+            frame = requested_;
+            bRequested_ = false;
+        }
+
+        compose(frame, buffers_[write_].data(), kernel_);
+
+        std::scoped_lock lock(mutex_);
+        std::swap(write_, ready_);
+        bFresh_ = true;
+    }
+}
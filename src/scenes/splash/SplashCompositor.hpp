@@ -0,0 +1,145 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <SFML/System/Vector3.hpp>
+
+namespace sf
+{
+    class Image;
+    class Texture;
+}
+
+namespace lpm
+{
+    /**
+     * @brief CPU version of splash.frag, for machines where GL is software rendered.
+     *
+     * On llvmpipe and friends, a fragment shader sampling six textures over the whole window is the most expensive
+     * thing on screen. The compositor produces the same image at scene resolution in a worker thread: the mask and
+     * top mask are turned into per pixel weights once, and every frame each row is blended from the four scrolled
+     * layers by a SIMD kernel (AVX2, SSE2 or NEON, scalar elsewhere). The main thread only uploads one texture.
+     *
+     * Math is 8 bit fixed point and every kernel gives the same result. Layers scroll by whole pixels.
+     */
+    class SplashCompositor
+    {
+    public:
+        static constexpr unsigned WIDTH  = 640;
+        static constexpr unsigned HEIGHT = 480;
+        static constexpr size_t LAYERS   = 4;
+
+        enum class EKernel : uint8_t
+        {
+            Scalar,
+            SSE2,
+            AVX2,
+            NEON
+        };
+
+        /**
+         * Uniforms of splash.frag for one frame
+         */
+        struct Frame
+        {
+            float time = 0.f;
+            std::array<float, LAYERS> intensities = {};
+            std::array<sf::Vector3f, LAYERS> displacements;     //< (offset, limit, velocity)
+        };
+
+    public:
+        SplashCompositor(const sf::Image& mask, const sf::Image& topMask);
+        ~SplashCompositor();
+
+        SplashCompositor(const SplashCompositor&) = delete;
+        SplashCompositor& operator=(const SplashCompositor&) = delete;
+
+    public:
+        /**
+         * Copy image into the back buffer of layer, shown after swapLayer
+         */
+        void setLayer(size_t index, const sf::Image& image);
+        void swapLayer(size_t index);
+
+        /**
+         * Ask worker to compose frame, replacing a request it didn't start yet
+         */
+        void request(const Frame& frame);
+
+        /**
+         * Upload last composed frame, if there is a new one
+         * @return False if worker didn't finish a frame since last call
+         */
+        bool collect(sf::Texture& texture);
+
+        /**
+         * Compose frame into RGBA pixels, WIDTH * HEIGHT * 4 bytes. Called by the worker.
+         */
+        void compose(const Frame& frame, uint8_t* pixels, EKernel kernel);
+
+    public:
+        /**
+         * Get best kernel supported by this CPU
+         */
+        [[nodiscard]] static EKernel getKernel();
+        [[nodiscard]] static const char* getKernelName(EKernel kernel);
+
+        /**
+         * Check if current GL context renders in software. Needs an active context.
+         */
+        [[nodiscard]] static bool isSoftwareRenderer();
+
+    private:
+        using Pixels = std::vector<uint8_t>;
+
+        void work();
+
+    private:
+        std::array<Pixels, LAYERS> weights_;        //< Per layer weight of every channel, from mask
+        Pixels top_;                                //< Top mask of every channel
+        std::array<Pixels, LAYERS> layers_;         //< Shown layers, read by the worker
+        std::array<Pixels, LAYERS> backLayers_;     //< Next layers, written by main thread
+
+        std::mutex layersMutex_;                    //< Guards layers_ while composing
+        std::mutex mutex_;
+        std::condition_variable wakeUp_;
+        Frame requested_;
+        bool bRequested_ = false;
+        bool bFresh_ = false;                       //< Ready buffer holds a frame not collected yet
+        bool bStop_ = false;
+
+        std::array<Pixels, 3> buffers_;             //< Triple buffer: worker writes, ready, main uploads
+        size_t write_ = 0;
+        size_t ready_ = 1;
+        size_t upload_ = 2;
+
+        EKernel kernel_;
+        std::thread worker_;                        //< Last member, so it starts after everything else is ready
+    };
+}
@@ -22,55 +22,155 @@
 #include "SplashNode.hpp"
 
 #include <cassert>
+#include <iostream>
 #include <imgui.h>
 
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/Shader.hpp>
+#include <SFML/Graphics/Sprite.hpp>
 #include <SFML/Graphics/Texture.hpp>
-#include <SFML/Graphics/RectangleShape.hpp>
-#include <SFML/Graphics/RenderStates.hpp>
-#include <SFML/Graphics/RenderTarget.hpp>
 
+#include <components/Material.hpp>
+#include <components/TextureCache.hpp>
 #include <scene/nodes/BackgroundNode.hpp>
+#include <scene/RenderQueue.hpp>
+#include <scene/Scene.hpp>
+#include <Engine.hpp>
 #include <Configuration.hpp>
 
+#include "SplashCompositor.hpp"
+
 
 
 using namespace lpm;
 
+namespace
+{
+    constexpr auto QUARTER = 1 - 1/4.f;
+    //constexpr auto FADE    = 1 - 1/40.f;
+
+    // Vector3(offset, limit, velocity)
+    const std::array<sf::Vector3f, 4> DISPLACEMENTS = {
+        sf::Vector3f(0,       QUARTER,  .10f),
+        sf::Vector3f(-1/4.f,  QUARTER,  .07f),
+        sf::Vector3f(-2/4.f,  QUARTER,  .09f),
+        sf::Vector3f(-3/4.f,  QUARTER,  .06f)
+    };
+
+    bool useCompositor()
+    {
+        const std::string_view mode = Configuration::SPLASH_COMPOSITOR ? Configuration::SPLASH_COMPOSITOR : "gpu";
+        if(mode == "cpu") return true;
+        if(mode != "auto") return false;
+
+        return !sf::Shader::isAvailable() || SplashCompositor::isSoftwareRenderer();
+    }
+}
+
 SplashNode::SplashNode()
-: shader_(std::make_unique<sf::Shader>())
-, rectangleShape_(std::make_unique<sf::RectangleShape>())
-, maskTexture_(std::make_unique<sf::Texture>())
+: maskTexture_(std::make_unique<sf::Texture>())
 , topMaskTexture_(std::make_unique<sf::Texture>())
 {
     initializeTextures();
     initializeShader();
 
-    rectangleShape_->setSize({Configuration::BACKGROUND_TEX_SIZE_X, Configuration::BACKGROUND_TEX_SIZE_Y});
-    rectangleShape_->setPosition(0,0);
-    rectangleShape_->setTexture(textures_[TEXTURE_0].get());
+    setQuadTexture(textures_[TEXTURE_0].get());
 }
 
 SplashNode::~SplashNode() = default;
 
+void SplashNode::init()
+{
+    loader_ = &getSceneOwner()->getEngine()->getLoader();
+    batch_ = loader_->createBatch();
+
+    if(useCompositor()) initializeCompositor();
+}
+
+void SplashNode::destroy()
+{
+    if(loader_) loader_->cancel(batch_);
+    compositor_.reset();
+}
+
+void SplashNode::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+    if(!compositor_)
+    {
+        ShaderNode::draw(target, states);
+        return;
+    }
+
+    states.transform *= getTransform();
+    target.draw(*compositeSprite_, states);
+}
+
+void SplashNode::submit(RenderQueue& queue, const sf::RenderStates& states) const
+{
+    if(!compositor_)
+    {
+        ShaderNode::submit(queue, states);
+        return;
+    }
+
+    sf::RenderStates spriteStates = states;
+    spriteStates.transform *= getTransform();
+    queue.submit(*compositeSprite_, spriteStates, getSceneNodeID());
+}
+
 void SplashNode::changeTexture(size_t index, std::string_view textureName)
 {
     assert(index <= 4 && "SplashNode::changeTexture called with value bigger than 4");
-    setTextureIntensityTarget(index, 0.f, [this, index, textureName = std::string(textureName.data())](){
-        initializeTexture(textures_[index].get(), textureName);
-        setTextureIntensityTarget(index, 1.f);
+
+    // Decoding runs while the current texture fades out
+    preload(textureName);
+
+    auto& swap = swaps_[index];
+    swap.fileName = textureName;
+    swap.bActive = true;
+    swap.bUploaded = false;
+    swap.bFadedOut = false;
+
+    setTextureIntensityTarget(index, 0.f, [this, index](){
+        swaps_[index].bFadedOut = true;
     });
 }
 
+void SplashNode::preload(std::string_view textureName)
+{
+    if(auto* decoded = findImage(textureName))
+    {
+        decoded->lastUse = ++useCounter_;
+        return;
+    }
+
+    // Least recently used image is replaced, images being decoded are kept
+    DecodedImage* slot = nullptr;
+    for(auto& decoded : images_)
+    {
+        if(!decoded.bLoading && (!slot || decoded.lastUse < slot->lastUse)) slot = &decoded;
+    }
+    if(!slot) return;
+
+    slot->fileName = textureName;
+    slot->image.reset();
+    slot->lastUse = ++useCounter_;
+    slot->bLoading = true;
+    loader_->load(textureName, EAssetType::Image, batch_);
+}
+
 
 
 void SplashNode::tick(float deltaTime)
 {
-    SceneNode::tick(deltaTime);
+    ShaderNode::tick(deltaTime);
 
     static float totalTime = 1988;
     totalTime += deltaTime;
-    shader_->setUniform("time", totalTime);
+    getMaterial().setFloat(timeUniform_, totalTime);
+
+    collectImages();
 
     for(size_t i = 0; i < texturesIntensities.size(); i++)
     {
@@ -94,16 +194,29 @@ void SplashNode::tick(float deltaTime)
         }
     }
 
-    shader_->setUniform("textures_intensity[0]", texturesIntensities[0]);
-    shader_->setUniform("textures_intensity[1]", texturesIntensities[1]);
-    shader_->setUniform("textures_intensity[2]", texturesIntensities[2]);
-    shader_->setUniform("textures_intensity[3]", texturesIntensities[3]);
-}
+    for(size_t i = 0; i < swaps_.size(); i++)
+    {
+        updateSwap(i);
+    }
 
-void SplashNode::draw(sf::RenderTarget& target, sf::RenderStates states) const
-{
-    states.shader = shader_.get();
-    target.draw(*rectangleShape_, states);
+    // Staged only, intensities at rest aren't uploaded again
+    for(size_t i = 0; i < texturesIntensities.size(); i++)
+    {
+        getMaterial().setFloat(intensityUniform_, texturesIntensities[i], i);
+    }
+
+    if(compositor_)
+    {
+        // Shows the frame requested last tick, the worker composes the next one meanwhile. It's uploaded into the
+        // texture the last recording doesn't draw, render thread may be drawing it.
+        auto& back = compositeTextures_[1 - compositeFront_];
+        if(compositor_->collect(*back))
+        {
+            compositeFront_ = 1 - compositeFront_;
+            compositeSprite_->setTexture(*back);
+        }
+        compositor_->request(SplashCompositor::Frame{ totalTime, texturesIntensities, DISPLACEMENTS });
+    }
 }
 
 void SplashNode::initializeTextures()
@@ -113,12 +226,15 @@ void SplashNode::initializeTextures()
     {
         textures_[i] = std::make_unique<sf::Texture>();
         textures_[i]->create(Configuration::BACKGROUND_TEX_SIZE_X, Configuration::BACKGROUND_TEX_SIZE_Y);
+
+        backTextures_[i] = std::make_unique<sf::Texture>();
+        backTextures_[i]->create(Configuration::BACKGROUND_TEX_SIZE_X, Configuration::BACKGROUND_TEX_SIZE_Y);
     }
 
     // Load mask
-    maskTexture_->loadFromFile("splash/splashMask.png");
+    TextureCache::loadTexture("splash/splashMask.png", *maskTexture_);
 
-    topMaskTexture_->loadFromFile("splash/topmask.png");
+    TextureCache::loadTexture("splash/topmask.png", *topMaskTexture_);
 
     std::ranges::fill(texturesIntensities, 0.f);
     std::ranges::fill(texturesIntensitiesTargets, 1.f);
@@ -126,32 +242,140 @@ void SplashNode::initializeTextures()
 
 void SplashNode::initializeShader()
 {
-    shader_->loadFromFile("splash/splash.frag", sf::Shader::Fragment);
+    loadFragmentShader("splash/splash.frag");
 
-    shader_->setUniform("mask_texture", *maskTexture_);
-    shader_->setUniform("top_mask_texture", *topMaskTexture_);
+    auto& material = getMaterial();
+    material.setTexture(material.addTexture("mask_texture"), *maskTexture_);
+    material.setTexture(material.addTexture("top_mask_texture"), *topMaskTexture_);
 
-    static constexpr auto quarter = 1 - 1/4.f;
-    //static constexpr auto fade    = 1 - 1/40.f;
+    const auto displacement = material.addVec3("displacement", DISPLACEMENTS.size());
+    for(size_t i = 0; i < DISPLACEMENTS.size(); i++)
+    {
+        material.setVec3(displacement, DISPLACEMENTS[i], i);
+    }
 
-    // Vector3(offset, limit, velocity)
-    shader_->setUniform("displacement[0]", sf::Vector3f(0,       quarter,  .10f));
-    shader_->setUniform("displacement[1]", sf::Vector3f(-1/4.f,  quarter,  .07f));
-    shader_->setUniform("displacement[2]", sf::Vector3f(-2/4.f,  quarter,  .09f));
-    shader_->setUniform("displacement[3]", sf::Vector3f(-3/4.f,  quarter,  .06f));
+    for(size_t i = 0; i < textures_.size(); i++)
+    {
+        textureUniforms_[i] = material.addTexture("textures[" + std::to_string(i) + "]");
+        material.setTexture(textureUniforms_[i], *textures_[i]);
+    }
+
+    timeUniform_ = material.addFloat("time");
+    intensityUniform_ = material.addFloat("textures_intensity", texturesIntensities.size());
+}
+
+void SplashNode::initializeTexture(sf::Texture& texture, const sf::Image& image)
+{
+    // Splash images share their size, so the back texture is usually just overwritten
+    if(texture.getSize() == image.getSize()) texture.update(image);
+    else texture.loadFromImage(image);
+
+    texture.setSrgb(false);
+    texture.setRepeated(true);
+    texture.setSmooth(true);
+}
+
+void SplashNode::initializeCompositor()
+{
+    sf::Image mask;
+    sf::Image topMask;
+    TextureCache::loadImage("splash/splashMask.png", mask);
+    TextureCache::loadImage("splash/topmask.png", topMask);
+
+    compositor_ = std::make_unique<SplashCompositor>(mask, topMask);
+
+    for(auto& texture : compositeTextures_)
+    {
+        texture = std::make_unique<sf::Texture>();
+        texture->create(SplashCompositor::WIDTH, SplashCompositor::HEIGHT);
+        texture->setSmooth(true);
+    }
+
+    // Same size as the shader quad, layers start black as the blank textures
+    compositeSprite_ = std::make_unique<sf::Sprite>(*compositeTextures_[compositeFront_]);
+}
+
+SplashNode::DecodedImage* SplashNode::findImage(std::string_view textureName)
+{
+    for(auto& decoded : images_)
+    {
+        if(!decoded.fileName.empty() && decoded.fileName == textureName) return &decoded;
+    }
+    return nullptr;
+}
+
+void SplashNode::collectImages()
+{
+    results_.clear();
+    if(!loader_ || loader_->collect(batch_, results_) == 0) return;
+
+    for(auto& result : results_)
+    {
+        auto* decoded = findImage(result.fileName);
+        if(!decoded || !decoded->bLoading) continue;
+
+        decoded->bLoading = false;
+        if(result.bLoaded)
+        {
+            decoded->image = std::move(result.image);
+            continue;
+        }
+
+        std::cerr << "Can't load splash image \042" << result.fileName << "\042\n";
+        decoded->fileName.clear();
+        decoded->lastUse = 0;
 
-    shader_->setUniform("textures[0]", *textures_[0]);
-    shader_->setUniform("textures[1]", *textures_[1]);
-    shader_->setUniform("textures[2]", *textures_[2]);
-    shader_->setUniform("textures[3]", *textures_[3]);
+        // Fade the current texture back in
+        for(size_t i = 0; i < swaps_.size(); i++)
+        {
+            if(swaps_[i].bActive && swaps_[i].fileName == result.fileName)
+            {
+                swaps_[i].bActive = false;
+                setTextureIntensityTarget(i, 1.f);
+            }
+        }
+    }
 }
 
-void SplashNode::initializeTexture(sf::Texture* texture, std::string_view textureName)
+void SplashNode::updateSwap(size_t index)
 {
-    texture->loadFromFile(textureName.data());
-    texture->setSrgb(false);
-    texture->setRepeated(true);
-    texture->setSmooth(true);
+    auto& swap = swaps_[index];
+    if(!swap.bActive) return;
+
+    if(!swap.bUploaded)
+    {
+        auto* decoded = findImage(swap.fileName);
+
+        // Replaced in the ring by newer preloads before it was used
+        if(!decoded)
+        {
+            preload(swap.fileName);
+            return;
+        }
+        if(!decoded->image) return;
+
+        if(compositor_) compositor_->setLayer(index, *decoded->image);
+        else initializeTexture(*backTextures_[index], *decoded->image);
+        decoded->lastUse = ++useCounter_;
+        swap.bUploaded = true;
+    }
+
+    if(swap.bFadedOut)
+    {
+        // Recording being drawn still samples the old front, it's uploaded into on a later tick at the earliest
+        if(compositor_) compositor_->swapLayer(index);
+        std::swap(textures_[index], backTextures_[index]);
+        bindTexture(index);
+        swap.bActive = false;
+        setTextureIntensityTarget(index, 1.f);
+    }
+}
+
+void SplashNode::bindTexture(size_t index)
+{
+    getMaterial().setTexture(textureUniforms_[index], *textures_[index]);
+
+    if(index == TEXTURE_0) setQuadTexture(textures_[TEXTURE_0].get());
 }
 
 
@@ -21,30 +21,41 @@
 
 #pragma once
 
-#include <scene/SceneNode.hpp>
+#include <scene/nodes/ShaderNode.hpp>
 #include <memory>
 #include <array>
+#include <cstdint>
 #include <functional>
+#include <string>
+#include <vector>
+
+#include <components/AsyncLoader.hpp>
+#include <components/Material.hpp>
 
 namespace sf
 {
-    class Shader;
+    class Image;
+    class Sprite;
     class Texture;
-    class RectangleShape;
-
-    class RenderTarget;
-    class RenderStates;
 }
 
 namespace lpm
 {
+    class SplashCompositor;
+
     /**
      * @brief Child node of SplashScene to draw splash.
      * 
      * SplashNode draw 4 differente textures with padding effect and blended together 
      * with mask texture. Can change textures at fly with fade-in and fade-out effect.
+     *
+     * New images are decoded in the AsyncLoader and uploaded into a back texture while the old one fades out. Both are
+     * swapped, and the fade-in starts, once the fade-out ended and the upload is done. The last RING_SIZE decoded
+     * images are kept, so cycling through the splash images only reads the disk once.
+     *
+     * On software GL the shader is replaced by SplashCompositor, see Configuration::SPLASH_COMPOSITOR.
      */
-    class SplashNode : public SceneNode
+    class SplashNode : public ShaderNode
     {
     public:
         static constexpr size_t TEXTURE_0 = 0;
@@ -52,6 +63,8 @@ namespace lpm
         static constexpr size_t TEXTURE_2 = 2;
         static constexpr size_t TEXTURE_3 = 3;
 
+        static constexpr size_t RING_SIZE = 8;     //< Decoded images kept, one per splash image
+
     public:
         SplashNode();
         ~SplashNode();
@@ -59,21 +72,50 @@ namespace lpm
     public:
         void changeTexture(size_t index, std::string_view textureName);
 
-    protected:
+        /**
+         * Decode image ahead of time, so a later changeTexture doesn't wait for it
+         */
+        void preload(std::string_view textureName);
+
         void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+    protected:
+        void init() override;
         void tick(float deltaTime) override;
+        void destroy() override;
+        void submit(RenderQueue& queue, const sf::RenderStates& states) const override;
 
     private:
+        struct DecodedImage
+        {
+            std::string fileName;
+            std::unique_ptr<sf::Image> image;   //< Null while loading
+            uint64_t lastUse = 0;
+            bool bLoading = false;
+        };
+
+        struct TextureSwap
+        {
+            std::string fileName;
+            bool bActive = false;
+            bool bUploaded = false;             //< Back texture holds the new image
+            bool bFadedOut = false;             //< Front texture finished fading out
+        };
+
         void initializeTextures();
         void initializeShader();
-        void initializeTexture(sf::Texture* texture, std::string_view textureName);
+        void initializeTexture(sf::Texture& texture, const sf::Image& image);
+        void initializeCompositor();
+
+        DecodedImage* findImage(std::string_view textureName);
+        void collectImages();
+        void updateSwap(size_t index);
+        void bindTexture(size_t index);
 
         void setTextureIntensityTarget(size_t index, float intensity, std::function<void()> const& callback = {});
 
 
     private:
-        std::unique_ptr<sf::Shader> shader_;
-        std::unique_ptr<sf::RectangleShape> rectangleShape_;
         std::unique_ptr<sf::Texture> maskTexture_;
         std::unique_ptr<sf::Texture> topMaskTexture_;
 
@@ -82,5 +124,23 @@ namespace lpm
         std::array<float, 4> texturesIntensities;
         std::array<float, 4> texturesIntensitiesTargets;
         std::array<std::function<void()>, 4> texturesIntensitiesCallbacks;
+
+        Material::Uniform timeUniform_ = 0;
+        Material::Uniform intensityUniform_ = 0;
+        std::array<Material::Uniform, 4> textureUniforms_ = {};
+
+        std::array<std::unique_ptr<sf::Texture>, 4> backTextures_;
+        std::array<TextureSwap, 4> swaps_;
+        std::array<DecodedImage, RING_SIZE> images_;
+        uint64_t useCounter_ = 0;
+
+        AsyncLoader* loader_ = nullptr;
+        uint32_t batch_ = 0;
+        std::vector<AsyncLoader::Result> results_;
+
+        std::unique_ptr<SplashCompositor> compositor_;     //< Null when drawn by the shader
+        std::array<std::unique_ptr<sf::Texture>, 2> compositeTextures_;   //< Front one is drawn, frames are uploaded into the other
+        size_t compositeFront_ = 0;
+        std::unique_ptr<sf::Sprite> compositeSprite_;
     };
 }
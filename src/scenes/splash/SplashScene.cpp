@@ -51,6 +51,12 @@ SplashScene::SplashScene(Engine* engine)
     splash->changeTexture(SplashNode::TEXTURE_2, "splash/splash02.jpg");
     splash->changeTexture(SplashNode::TEXTURE_3, "splash/splash03.jpg");
 
+    // Rest of the splash images decode in background, so later changes don't wait for the disk
+    for(size_t i = 0; i < SplashNode::RING_SIZE; i++)
+    {
+        splash->preload("splash/splash0" + std::to_string(i) + ".jpg");
+    }
+
     auto& logoTextShadow = addSceneNode<lpm::Text>("FontLogo", 150);
     logoTextShadow.setTextFillColor(sf::Color::Black);
     logoTextShadow.setTextString("La Prision");
@@ -0,0 +1,168 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "ChatNode.hpp"
+
+#include <algorithm>
+
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Text.hpp>
+
+#include <chat/ChatLog.hpp>
+#include <scene/RenderQueue.hpp>
+#include <scene/Scene.hpp>
+#include <Engine.hpp>
+#include <Resources.hpp>
+
+using namespace lpm;
+
+namespace
+{
+    sf::Color getChannelColor(EChatChannel channel)
+    {
+        switch(channel)
+        {
+            case EChatChannel::Global:  return sf::Color::Yellow;
+            case EChatChannel::Room:    return {0, 200, 255};
+            case EChatChannel::Private: return {255, 120, 255};
+            case EChatChannel::Player:  break;
+        }
+        return sf::Color::White;
+    }
+}
+
+ChatNode::ChatNode(const ChatLog* log)
+: log_(log)
+{
+    for(auto& line : lines_)
+    {
+        line.text = std::make_unique<sf::Text>();
+    }
+}
+
+ChatNode::~ChatNode() = default;
+
+void ChatNode::scroll(int lines)
+{
+    const auto maxScroll = static_cast<int>(log_->size() > VISIBLE_LINES ? log_->size() - VISIBLE_LINES : 0);
+    scroll_ = static_cast<size_t>(std::clamp(static_cast<int>(scroll_) + lines, 0, maxScroll));
+}
+
+void ChatNode::init()
+{
+    const auto& resources = getSceneOwner()->getEngine()->getResources();
+
+    if(auto font = resources.getFont("FontEntry"))
+    {
+        for(auto& line : lines_)
+        {
+            line.text->setFont(**font);
+            line.text->setCharacterSize(FONT_SIZE);
+        }
+    }
+    else
+    {
+        throw resource_exception();
+    }
+}
+
+void ChatNode::tick(float deltaTime)
+{
+    SceneNode::tick(deltaTime);
+
+    if(layoutSequence_ == log_->getNextSequence() && layoutScroll_ == scroll_)
+    {
+        return;
+    }
+
+    visibleCount_ = std::min(VISIBLE_LINES, log_->size() > scroll_ ? log_->size() - scroll_ : 0);
+
+    // Keep lines whose message is still visible, the rest are free to lay out new messages
+    std::array<bool, VISIBLE_LINES> used {};
+    std::array<bool, VISIBLE_LINES> placed {};
+    for(size_t row = 0; row < visibleCount_; row++)
+    {
+        const auto sequence = log_->getLine(scroll_ + row).sequence;
+        for(size_t i = 0; i < lines_.size(); i++)
+        {
+            if(lines_[i].sequence == sequence)
+            {
+                visible_[row] = i;
+                used[i]       = true;
+                placed[row]   = true;
+                break;
+            }
+        }
+    }
+
+    for(size_t row = 0; row < visibleCount_; row++)
+    {
+        if(placed[row]) continue;
+
+        const auto freeLine = static_cast<size_t>(std::distance(used.begin(), std::ranges::find(used, false)));
+        used[freeLine] = true;
+        visible_[row]  = freeLine;
+
+        const auto message = log_->getLine(scroll_ + row);
+        auto& line = lines_[freeLine];
+        line.sequence = message.sequence;
+
+        sf::String string;
+        if(!message.sender.empty())
+        {
+            string = sf::String::fromUtf8(message.sender.begin(), message.sender.end());
+            string += ": ";
+        }
+        string += sf::String::fromUtf8(message.text.begin(), message.text.end());
+
+        line.text->setString(string);
+        line.text->setFillColor(getChannelColor(message.channel));
+    }
+
+    // Newest message at bottom
+    for(size_t row = 0; row < visibleCount_; row++)
+    {
+        lines_[visible_[row]].text->setPosition(0.f, -LINE_HEIGHT * static_cast<float>(row + 1));
+    }
+
+    layoutSequence_ = log_->getNextSequence();
+    layoutScroll_   = scroll_;
+}
+
+void ChatNode::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+    states.transform *= getTransform();
+    for(size_t row = 0; row < visibleCount_; row++)
+    {
+        target.draw(*lines_[visible_[row]].text, states);
+    }
+}
+
+void ChatNode::submit(RenderQueue& queue, const sf::RenderStates& states) const
+{
+    // Glyphs of new lines are loaded here, while no frame is drawn
+    sf::RenderStates lineStates = states;
+    lineStates.transform *= getTransform();
+    for(size_t row = 0; row < visibleCount_; row++)
+    {
+        queue.submit(*lines_[visible_[row]].text, lineStates, getSceneNodeID());
+    }
+}
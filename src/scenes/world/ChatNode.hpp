@@ -0,0 +1,90 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <scene/SceneNode.hpp>
+#include <array>
+#include <memory>
+
+namespace sf
+{
+    class Text;
+}
+
+namespace lpm
+{
+    class ChatLog;
+
+    /**
+     * @brief Draw the newest lines of a ChatLog.
+     *
+     * Only VISIBLE_LINES sf::Text are ever created. Each one remembers the sequence of the message it has laid out,
+     * so a line is only rebuilt when a new message scrolls into view. Per-frame cost doesn't depend on how many
+     * messages the log holds.
+     */
+    class ChatNode final : public SceneNode
+    {
+    public:
+        static constexpr size_t VISIBLE_LINES = 8;
+        static constexpr unsigned FONT_SIZE   = 14;
+        static constexpr float LINE_HEIGHT    = 16.f;
+
+    public:
+        explicit ChatNode(const ChatLog* log);
+        ~ChatNode() override;
+
+    public:
+        /**
+         * Move view through history
+         * @param lines Positive values show older messages
+         */
+        void scroll(int lines);
+
+    public:
+        void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+    protected:
+        void init() override;
+        void tick(float deltaTime) override;
+        void submit(RenderQueue& queue, const sf::RenderStates& states) const override;
+
+    private:
+        static constexpr uint64_t NO_SEQUENCE = std::numeric_limits<uint64_t>::max();
+
+        struct CachedLine
+        {
+            uint64_t sequence = NO_SEQUENCE;
+            std::unique_ptr<sf::Text> text;
+        };
+
+    private:
+        const ChatLog* log_;
+
+        std::array<CachedLine, VISIBLE_LINES> lines_;
+        std::array<size_t, VISIBLE_LINES> visible_ {};     //< Index in lines_ of each row, newest first
+        size_t visibleCount_ = 0;
+
+        size_t scroll_ = 0;
+        uint64_t layoutSequence_ = NO_SEQUENCE;             //< Log sequence when layout was built
+        size_t layoutScroll_     = 0;
+    };
+}
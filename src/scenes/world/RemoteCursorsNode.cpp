@@ -0,0 +1,115 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "RemoteCursorsNode.hpp"
+
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+
+#include <components/Animator.hpp>
+#include <network/InterestManager.hpp>
+#include <player/PlayerRegistry.hpp>
+#include <scene/RenderQueue.hpp>
+#include <scene/Scene.hpp>
+#include <Engine.hpp>
+#include <Resources.hpp>
+
+using namespace lpm;
+
+RemoteCursorsNode::RemoteCursorsNode(const InterestManager* interest, const PlayerRegistry* players)
+: interest_(interest)
+, players_(players)
+, animator_(std::make_unique<Animator>())
+, vertices_(std::make_unique<sf::VertexArray>(sf::Quads))
+{
+    animator_->loadAnimations("cursors.json");
+}
+
+RemoteCursorsNode::~RemoteCursorsNode() = default;
+
+void RemoteCursorsNode::init()
+{
+    if(auto texture = getSceneOwner()->getEngine()->getResources().getTexture("Cursors"))
+    {
+        texture_ = *texture;
+    }
+    else
+    {
+        throw resource_exception();
+    }
+}
+
+void RemoteCursorsNode::tick(float deltaTime)
+{
+    SceneNode::tick(deltaTime);
+
+    const auto detailed = interest_->getDetailedPlayers();
+    vertices_->resize(detailed.size() * 4);
+
+    const auto view = Scene::getViewArea();
+    size_t visible = 0;
+
+    const auto positions  = players_->getPositions();
+    const auto animations = players_->getCursorAnimations();
+    const auto times      = players_->getCursorTimes();
+
+    for(size_t i = 0; i < detailed.size(); i++)
+    {
+        const auto dense = players_->getDenseIndex(detailed[i]);
+        const auto rect  = animator_->getRect(animations[dense], times[dense]);
+        const auto pos   = positions[dense];
+
+        const auto w = static_cast<float>(rect.width);
+        const auto h = static_cast<float>(rect.height);
+        const auto u = static_cast<float>(rect.left);
+        const auto v = static_cast<float>(rect.top);
+
+        // Cursors of players looking at parts of the camera out of view
+        if(!view.intersects({ pos.x, pos.y, w, h })) continue;
+
+        sf::Vertex* quad = &(*vertices_)[visible++ * 4];
+        quad[0] = sf::Vertex({pos.x,     pos.y    }, {u,     v    });
+        quad[1] = sf::Vertex({pos.x + w, pos.y    }, {u + w, v    });
+        quad[2] = sf::Vertex({pos.x + w, pos.y + h}, {u + w, v + h});
+        quad[3] = sf::Vertex({pos.x,     pos.y + h}, {u,     v + h});
+    }
+
+    vertices_->resize(visible * 4);
+}
+
+void RemoteCursorsNode::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+    if(vertices_->getVertexCount() == 0) return;
+
+    states.transform *= getTransform();
+    states.texture = texture_;
+    target.draw(*vertices_, states);
+}
+
+void RemoteCursorsNode::submit(RenderQueue& queue, const sf::RenderStates& states) const
+{
+    if(vertices_->getVertexCount() == 0) return;
+
+    sf::RenderStates cursorStates = states;
+    cursorStates.transform *= getTransform();
+    cursorStates.texture = texture_;
+    queue.submit({ &(*vertices_)[0], vertices_->getVertexCount() }, sf::Quads, cursorStates, getSceneNodeID());
+}
@@ -0,0 +1,66 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <scene/SceneNode.hpp>
+#include <memory>
+
+namespace sf
+{
+    class Texture;
+    class VertexArray;
+}
+
+namespace lpm
+{
+    class Animator;
+    class InterestManager;
+    class PlayerRegistry;
+
+    /**
+     * @brief Draw cursors of remote players in the current camera.
+     *
+     * Only players reported by InterestManager::getDetailedPlayers are drawn, all of them with one draw call.
+     */
+    class RemoteCursorsNode final : public SceneNode
+    {
+    public:
+        RemoteCursorsNode(const InterestManager* interest, const PlayerRegistry* players);
+        ~RemoteCursorsNode() override;
+
+    public:
+        void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+    protected:
+        void init() override;
+        void tick(float deltaTime) override;
+        void submit(RenderQueue& queue, const sf::RenderStates& states) const override;
+
+    private:
+        const InterestManager* interest_;
+        const PlayerRegistry* players_;
+
+        std::unique_ptr<Animator> animator_;
+        std::unique_ptr<sf::VertexArray> vertices_;
+        const sf::Texture* texture_ = nullptr;
+    };
+}
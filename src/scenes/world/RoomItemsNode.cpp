@@ -0,0 +1,239 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "RoomItemsNode.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+
+#include <components/Hash.hpp>
+#include <network/INetwork.hpp>
+#include <scene/RenderQueue.hpp>
+#include <scene/Scene.hpp>
+#include <Engine.hpp>
+
+using namespace lpm;
+
+namespace
+{
+    std::string getTextureFile(std::string_view kind)
+    {
+        return "item_" + std::string(kind) + ".png";
+    }
+
+    sf::Color getPlaceholderColor(std::string_view kind)
+    {
+        const uint32_t hash = hashName(kind);
+        return { static_cast<uint8_t>(hash | 0x40), static_cast<uint8_t>((hash >> 8) | 0x40), static_cast<uint8_t>((hash >> 16) | 0x40) };
+    }
+}
+
+RoomItemsNode::RoomItemsNode(INetwork* network)
+: network_(network)
+, vertices_(std::make_unique<sf::VertexArray>(sf::Quads, items_.capacity() * 4))
+{
+    auto& events = network_->getEvents();
+    subscriptions_ = {
+        events.subscribe<NetworkEvent::SpawnItem>(NetworkEventBus::Handler<NetworkEvent::SpawnItem>::bind<&RoomItemsNode::onSpawnItem>(this)),
+        events.subscribe<NetworkEvent::DestroyItem>(NetworkEventBus::Handler<NetworkEvent::DestroyItem>::bind<&RoomItemsNode::onDestroyItem>(this)),
+        events.subscribe<NetworkEvent::RoomChanged>(NetworkEventBus::Handler<NetworkEvent::RoomChanged>::bind<&RoomItemsNode::onRoomChanged>(this))
+    };
+}
+
+RoomItemsNode::~RoomItemsNode()
+{
+    for(const auto subscription : subscriptions_)
+    {
+        network_->getEvents().unsubscribe(subscription);
+    }
+
+    if(loader_) loader_->cancel(batch_);
+}
+
+void RoomItemsNode::init()
+{
+    loader_ = &getSceneOwner()->getEngine()->getLoader();
+    batch_  = loader_->createBatch();
+}
+
+void RoomItemsNode::tick(float deltaTime)
+{
+    SceneNode::tick(deltaTime);
+
+    // Items destroyed during the last frame were still drawn, now nobody reads them
+    items_.flushDestroyed();
+
+    requestTextures();
+    uploadTextures();
+    buildVertices();
+}
+
+void RoomItemsNode::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+    states.transform *= getTransform();
+
+    for(size_t kind = 0; kind < items_.getKindCount(); kind++)
+    {
+        const auto& batch = batches_[kind];
+        if(batch.count == 0) continue;
+
+        states.texture = textures_[kind].get();
+        target.draw(&(*vertices_)[batch.first], batch.count, sf::Quads, states);
+    }
+}
+
+void RoomItemsNode::submit(RenderQueue& queue, const sf::RenderStates& states) const
+{
+    sf::RenderStates kindStates = states;
+    kindStates.transform *= getTransform();
+
+    for(size_t kind = 0; kind < items_.getKindCount(); kind++)
+    {
+        const auto& batch = batches_[kind];
+        if(batch.count == 0) continue;
+
+        kindStates.texture = textures_[kind].get();
+        queue.submit({ &(*vertices_)[batch.first], batch.count }, sf::Quads, kindStates, getSceneNodeID());
+    }
+}
+
+void RoomItemsNode::onSpawnItem(const NetworkEvent::SpawnItem& event)
+{
+    const sf::Vector2f position(static_cast<float>(event.posX), static_cast<float>(event.posY));
+    if(!items_.spawn(event.item, event.name, position).isValid())
+    {
+        std::cerr << "Can't spawn item " << event.item << ", room is full\n";
+    }
+}
+
+void RoomItemsNode::onDestroyItem(const NetworkEvent::DestroyItem& event)
+{
+    items_.destroyLater(items_.find(event.item));
+}
+
+void RoomItemsNode::onRoomChanged(const NetworkEvent::RoomChanged& event)
+{
+    // Server spawns the items of the new room again
+    if(event.accepted) items_.clear();
+}
+
+void RoomItemsNode::requestTextures()
+{
+    if(!loader_) return;
+
+    for(; requestedKinds_ < items_.getKindCount(); requestedKinds_++)
+    {
+        const auto kind = static_cast<uint16_t>(requestedKinds_);
+        loader_->load(getTextureFile(items_.getKindName(kind)), EAssetType::Image, batch_);
+    }
+}
+
+void RoomItemsNode::uploadTextures()
+{
+    if(!loader_) return;
+
+    results_.clear();
+    if(loader_->collect(batch_, results_) == 0) return;
+
+    for(auto& result : results_)
+    {
+        if(!result.bLoaded)
+        {
+            std::cerr << "Can't load item texture \042" << result.fileName << "\042\n";
+            continue;
+        }
+
+        for(size_t kind = 0; kind < items_.getKindCount(); kind++)
+        {
+            if(getTextureFile(items_.getKindName(static_cast<uint16_t>(kind))) != result.fileName) continue;
+
+            if(auto texture = std::make_unique<sf::Texture>(); texture->loadFromImage(*result.image))
+            {
+                getSceneOwner()->retire(std::move(textures_[kind]));
+                textures_[kind] = std::move(texture);
+            }
+            break;
+        }
+    }
+}
+
+void RoomItemsNode::buildVertices()
+{
+    const auto positions = items_.getPositions();
+    const auto kinds     = items_.getKinds();
+
+    // Items are centered on their position, items out of view aren't drawn
+    std::array<sf::Vector2f, RoomItems::MAX_KINDS> sizes;
+    for(size_t kind = 0; kind < items_.getKindCount(); kind++)
+    {
+        const auto* texture = textures_[kind].get();
+        sizes[kind] = texture ? sf::Vector2f(texture->getSize()) : sf::Vector2f(PLACEHOLDER_SIZE, PLACEHOLDER_SIZE);
+    }
+
+    const auto view = Scene::getViewArea();
+    const auto isVisible = [&](size_t dense){
+        const auto size = sizes[kinds[dense]];
+        return view.intersects({ positions[dense] - size / 2.f, size });
+    };
+
+    // Counting sort by kind, so every kind is one contiguous range and one draw call
+    batches_.fill({});
+    for(size_t dense = 0; dense < positions.size(); dense++)
+    {
+        if(isVisible(dense)) batches_[kinds[dense]].count += 4;
+    }
+
+    size_t first = 0;
+    for(auto& batch : batches_)
+    {
+        batch.first = first;
+        first += batch.count;
+    }
+
+    std::array<size_t, RoomItems::MAX_KINDS> cursors;
+    std::ranges::transform(batches_, cursors.begin(), [](const KindBatch& batch){ return batch.first; });
+
+    for(size_t dense = 0; dense < positions.size(); dense++)
+    {
+        if(!isVisible(dense)) continue;
+
+        const auto kind = kinds[dense];
+        const auto size = sizes[kind];
+        const sf::Color color = textures_[kind] ? sf::Color::White : getPlaceholderColor(items_.getKindName(kind));
+
+        const auto pos = positions[dense] - size / 2.f;
+        const auto w = size.x;
+        const auto h = size.y;
+
+        sf::Vertex* quad = &(*vertices_)[cursors[kind]];
+        quad[0] = sf::Vertex({pos.x,     pos.y    }, color, {0.f, 0.f});
+        quad[1] = sf::Vertex({pos.x + w, pos.y    }, color, {w,   0.f});
+        quad[2] = sf::Vertex({pos.x + w, pos.y + h}, color, {w,   h  });
+        quad[3] = sf::Vertex({pos.x,     pos.y + h}, color, {0.f, h  });
+        cursors[kind] += 4;
+    }
+}
@@ -0,0 +1,100 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include <components/AsyncLoader.hpp>
+#include <network/NetworkEvents.hpp>
+#include <scene/SceneNode.hpp>
+#include <scenes/world/room/RoomItems.hpp>
+
+namespace sf
+{
+    class Texture;
+    class VertexArray;
+}
+
+namespace lpm
+{
+    class INetwork;
+
+    /**
+     * @brief Items spawned in the room by the server.
+     *
+     * Keeps RoomItems in sync with NetworkEvent::SpawnItem and NetworkEvent::DestroyItem, and draws every item with one
+     * draw call per kind. Kind textures ("item_<kind>.png") are decoded by AsyncLoader the first time a kind is seen,
+     * meanwhile items are drawn as plain quads.
+     */
+    class RoomItemsNode final : public SceneNode
+    {
+    public:
+        static constexpr float PLACEHOLDER_SIZE = 16.f;
+
+    public:
+        explicit RoomItemsNode(INetwork* network);
+        ~RoomItemsNode() override;
+
+    public:
+        void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+        [[nodiscard]] RoomItems& getItems() { return items_; }
+        [[nodiscard]] const RoomItems& getItems() const { return items_; }
+
+    protected:
+        void init() override;
+        void tick(float deltaTime) override;
+        void submit(RenderQueue& queue, const sf::RenderStates& states) const override;
+
+    private:
+        struct KindBatch
+        {
+            size_t first = 0;                   //< First vertex of the kind
+            size_t count = 0;                   //< Vertices of the kind
+        };
+
+        void onSpawnItem(const NetworkEvent::SpawnItem& event);
+        void onDestroyItem(const NetworkEvent::DestroyItem& event);
+        void onRoomChanged(const NetworkEvent::RoomChanged& event);
+
+        void requestTextures();
+        void uploadTextures();
+        void buildVertices();
+
+    private:
+        INetwork* network_;
+        AsyncLoader* loader_ = nullptr;
+        std::vector<NetworkEventBus::Subscription> subscriptions_;
+
+        RoomItems items_;
+
+        uint32_t batch_ = 0;
+        size_t requestedKinds_ = 0;             //< Kinds whose texture was already requested
+        std::vector<AsyncLoader::Result> results_;
+        std::array<std::unique_ptr<sf::Texture>, RoomItems::MAX_KINDS> textures_;
+
+        std::unique_ptr<sf::VertexArray> vertices_;
+        std::array<KindBatch, RoomItems::MAX_KINDS> batches_ {};
+    };
+}
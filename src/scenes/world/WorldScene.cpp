@@ -21,21 +21,39 @@
 
 #include "WorldScene.hpp"
 
-#include <scene/nodes/BackgroundNode.hpp>
 #include <scenes/world/room/RoomSceneNode.hpp>
+#include <scenes/world/RemoteCursorsNode.hpp>
+#include <scenes/world/RoomItemsNode.hpp>
+#include <scenes/world/ChatNode.hpp>
+#include <network/INetwork.hpp>
+#include <network/InterestManager.hpp>
 
 #include <Engine.hpp>
+#include <Configuration.hpp>
 #include <widgets/Cursor.hpp>
 
 using namespace lpm;
 
 WorldScene::WorldScene(Engine* engine) : Scene(engine)
+, interest_(std::make_unique<InterestManager>(engine->getNetwork()))
 {
-    addSceneNode<BackgroundNode>("AL_Almacen1.jpg")
-    .setName("Background")
-    .setDrawOrder(CommonDepths::BACKGROUND);
+    setGroupStatic(CommonDepths::BACKGROUND);
 
-    addSceneNode<RoomSceneNode>();
+    auto& room = addSceneNode<RoomSceneNode>(interest_.get());
+    room.setName("Room").setDrawOrder(CommonDepths::BACKGROUND);
+    room.changeRoom("Almacen");
+
+    addSceneNode<RoomItemsNode>(&engine->getNetwork())
+    .setName("RoomItems")
+    .setDrawOrder(CommonDepths::MIDDLE);
+
+    addSceneNode<RemoteCursorsNode>(interest_.get(), &engine->getNetwork().getPlayers())
+    .setName("RemoteCursors")
+    .setDrawOrder(CommonDepths::FOREGROUND);
+
+    auto& chat = addSceneNode<ChatNode>(&engine->getChat());
+    chat.setName("Chat").setDrawOrder(CommonDepths::FOREGROUND, 1);
+    chat.setPosition(8.f, Configuration::BACKGROUND_TEX_SIZE_Y - 8.f);
 
     getEngine()->getCursor().setCursor("default");
 }
@@ -47,5 +65,5 @@ WorldScene::~WorldScene()
 
 void WorldScene::tick(float deltaTime)
 {
-    deltaTime++;
+    Scene::tick(deltaTime);
 }
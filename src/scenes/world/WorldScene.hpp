@@ -25,16 +25,22 @@
 
 namespace lpm
 {
+    class InterestManager;
+
     class WorldScene : public Scene
     {
     public:
         WorldScene(class Engine* engine);
         ~WorldScene() override;
 
+    public:
+        [[nodiscard]] InterestManager& getInterest() const { return *interest_; }
+
     protected:
         void tick(float deltaTime) override;
 
     private:
         std::unique_ptr<class RoomSceneNode> room_;
+        std::unique_ptr<InterestManager> interest_;
     };
 }
@@ -0,0 +1,169 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "AreaMap.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include <SFML/Graphics/Image.hpp>
+
+using namespace lpm;
+
+namespace
+{
+    constexpr size_t CELLS = static_cast<size_t>(AreaMap::WIDTH) * AreaMap::HEIGHT;
+    constexpr size_t NARROW_AREAS = 0xFF - 1;
+}
+
+AreaMap::AreaMap()
+: narrow_(CELLS, 0)
+{
+}
+
+void AreaMap::rasterize(const RoomDatabase::Camera& camera)
+{
+    reset(camera.getAreaCount());
+
+    std::vector<float> crossings;
+    for(size_t area = 0; area < areaCount_; area++)
+    {
+        const auto vertices = camera.getArea(area).getVertices();
+        if(vertices.size() < 3) continue;
+
+        // Scanline even-odd fill, sampling pixel centers
+        for(unsigned y = 0; y < HEIGHT; y++)
+        {
+            const float sampleY = static_cast<float>(y) + 0.5f;
+
+            crossings.clear();
+            for(size_t i = 0, j = vertices.size() - 1; i < vertices.size(); j = i++)
+            {
+                const float ay = vertices[i].y, by = vertices[j].y;
+                if((ay <= sampleY) == (by <= sampleY)) continue;
+
+                const float ax = vertices[i].x, bx = vertices[j].x;
+                crossings.push_back(ax + (sampleY - ay) * (bx - ax) / (by - ay));
+            }
+            std::sort(crossings.begin(), crossings.end());
+
+            for(size_t i = 0; i + 1 < crossings.size(); i += 2)
+            {
+                const auto first = static_cast<long>(std::ceil(crossings[i] - 0.5f));
+                const auto last  = static_cast<long>(std::ceil(crossings[i + 1] - 0.5f));
+                for(long x = std::max(first, 0L); x < std::min(last, static_cast<long>(WIDTH)); x++)
+                {
+                    setCell(static_cast<size_t>(y) * WIDTH + static_cast<size_t>(x), static_cast<uint16_t>(area));
+                }
+            }
+        }
+    }
+}
+
+void AreaMap::loadMask(const sf::Image& mask, const RoomDatabase::Camera& camera)
+{
+    reset(camera.getAreaCount());
+
+    const auto size = mask.getSize();
+    const uint8_t* pixels = mask.getPixelsPtr();
+    if(!pixels || size.x == 0 || size.y == 0) return;
+
+    struct AreaColor
+    {
+        int r, g, b;
+    };
+    std::vector<AreaColor> colors(areaCount_);
+    for(size_t area = 0; area < areaCount_; area++)
+    {
+        const uint32_t color = camera.getArea(area).getDebugColor();
+        colors[area] = { static_cast<int>(color >> 24), static_cast<int>((color >> 16) & 0xFF), static_cast<int>((color >> 8) & 0xFF) };
+    }
+
+    for(unsigned y = 0; y < HEIGHT; y++)
+    {
+        const size_t maskY = static_cast<size_t>(y) * size.y / HEIGHT;
+        for(unsigned x = 0; x < WIDTH; x++)
+        {
+            const size_t maskX = static_cast<size_t>(x) * size.x / WIDTH;
+            const uint8_t* pixel = pixels + (maskY * size.x + maskX) * 4;
+
+            // Later areas win, same as rasterize
+            for(size_t area = areaCount_; area > 0; area--)
+            {
+                const auto& color = colors[area - 1];
+                if(std::abs(pixel[0] - color.r) <= MASK_TOLERANCE
+                && std::abs(pixel[1] - color.g) <= MASK_TOLERANCE
+                && std::abs(pixel[2] - color.b) <= MASK_TOLERANCE)
+                {
+                    setCell(static_cast<size_t>(y) * WIDTH + x, static_cast<uint16_t>(area - 1));
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void AreaMap::clear()
+{
+    reset(0);
+}
+
+void AreaMap::find(std::span<const sf::Vector2f> points, std::span<uint16_t> areas) const
+{
+    const size_t count = std::min(points.size(), areas.size());
+
+    // Width is picked once for the whole batch instead of per point
+    auto resolve = [&](const auto& cells){
+        for(size_t i = 0; i < count; i++)
+        {
+            const auto x = static_cast<int>(points[i].x);
+            const auto y = static_cast<int>(points[i].y);
+            const bool bInside = points[i].x >= 0.f && points[i].y >= 0.f && x < static_cast<int>(WIDTH) && y < static_cast<int>(HEIGHT);
+            areas[i] = bInside ? static_cast<uint16_t>(cells[static_cast<size_t>(y) * WIDTH + static_cast<size_t>(x)] - 1) : NO_AREA;
+        }
+    };
+
+    if(bWide_) resolve(wide_);
+    else       resolve(narrow_);
+}
+
+void AreaMap::reset(size_t areaCount)
+{
+    areaCount_ = areaCount;
+    bWide_ = areaCount > NARROW_AREAS;
+
+    if(bWide_)
+    {
+        wide_.assign(CELLS, 0);
+    }
+    else
+    {
+        wide_ = {};
+        std::fill(narrow_.begin(), narrow_.end(), 0);
+    }
+}
+
+void AreaMap::setCell(size_t cell, uint16_t area)
+{
+    if(bWide_) wide_[cell] = static_cast<uint16_t>(area + 1);
+    else       narrow_[cell] = static_cast<uint8_t>(area + 1);
+}
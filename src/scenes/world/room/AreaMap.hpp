@@ -0,0 +1,112 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <SFML/System/Vector2.hpp>
+
+#include <Configuration.hpp>
+#include <scenes/world/room/RoomDatabase.hpp>
+
+namespace sf
+{
+    class Image;
+}
+
+namespace lpm
+{
+    /**
+     * @brief Area under each pixel of a camera.
+     *
+     * Camera areas are baked into a WIDTH x HEIGHT map of area indices, either rasterizing their polygons or reading
+     * the mask shipped with the camera, so resolving the area under a point is a single array read no matter how many
+     * areas the camera has. Later areas are on top of earlier ones.
+     *
+     * Cells are 8 bits wide, or 16 bits for cameras with 255 areas or more.
+     */
+    class AreaMap
+    {
+    public:
+        static constexpr unsigned WIDTH  = Configuration::BACKGROUND_TEX_SIZE_X;
+        static constexpr unsigned HEIGHT = Configuration::BACKGROUND_TEX_SIZE_Y;
+        static constexpr uint16_t NO_AREA = 0xFFFF;
+
+        /**
+         * Max difference per channel between a mask pixel and the debug color of its area, absorbs antialiased edges
+         */
+        static constexpr int MASK_TOLERANCE = 48;
+
+    public:
+        AreaMap();
+
+    public:
+        /**
+         * Bake areas filling their polygons
+         */
+        void rasterize(const RoomDatabase::Camera& camera);
+
+        /**
+         * Bake areas from mask. Each pixel belongs to the area with the same debug color (alpha ignored), pixels
+         * matching no area belong to none. Masks of other sizes are sampled to WIDTH x HEIGHT.
+         */
+        void loadMask(const sf::Image& mask, const RoomDatabase::Camera& camera);
+
+        /**
+         * Remove every area
+         */
+        void clear();
+
+    public:
+        /**
+         * Get area under point
+         * @return Area index in the camera, NO_AREA if there is none or point is outside of the map
+         */
+        [[nodiscard]] uint16_t find(int x, int y) const
+        {
+            if(x < 0 || y < 0 || x >= static_cast<int>(WIDTH) || y >= static_cast<int>(HEIGHT)) return NO_AREA;
+
+            const auto cell = static_cast<size_t>(y) * WIDTH + static_cast<size_t>(x);
+            return static_cast<uint16_t>((bWide_ ? wide_[cell] : narrow_[cell]) - 1);
+        }
+
+        /**
+         * Get area under every point at once, e.g. all remote cursors
+         * @param areas Receives the area of each point, same size as points
+         */
+        void find(std::span<const sf::Vector2f> points, std::span<uint16_t> areas) const;
+
+        [[nodiscard]] size_t getAreaCount() const { return areaCount_; }
+
+    private:
+        void reset(size_t areaCount);
+        void setCell(size_t cell, uint16_t area);
+
+    private:
+        std::vector<uint8_t> narrow_;       //< Area + 1 per cell, 0 is none
+        std::vector<uint16_t> wide_;        //< Same, used when areas don't fit in narrow_
+        size_t areaCount_ = 0;
+        bool bWide_ = false;
+    };
+}
@@ -0,0 +1,147 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "AreaScripts.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+using namespace lpm;
+
+namespace
+{
+    struct ScriptContext
+    {
+        const RoomDatabase& database;
+        const RoomDatabase::Room& room;
+        const RoomDatabase::Area& area;
+    };
+
+    bool resolveChangeCamera(const ScriptContext& context, ScriptCommand& command)
+    {
+        const auto name = context.area.getParam(0);
+        for(size_t camera = 0; camera < context.room.getCameraCount(); camera++)
+        {
+            if(context.room.getCamera(camera).getName() == name)
+            {
+                command.camera = static_cast<uint16_t>(camera);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool resolveChangeRoom(const ScriptContext& context, ScriptCommand& command)
+    {
+        try
+        {
+            // Keep the name stored by the database, param text dies with the current room
+            const auto room = context.database.findRoom(context.area.getParam(0));
+            if(room) command.text = room->getName();
+            return room.has_value();
+        }
+        catch(const room_exception&)
+        {
+            return false;
+        }
+    }
+
+    bool resolveShowInfo(const ScriptContext& context, ScriptCommand& command)
+    {
+        command.text = context.area.getParamCount() > 0 ? context.area.getParam(0) : context.area.getComment();
+        return true;
+    }
+
+    /**
+     * Script verbs. New verbs only need an opcode, an entry here and a case where commands are run.
+     */
+    struct Verb
+    {
+        std::string_view name;
+        EScriptOp op;
+        size_t minParams;
+        size_t maxParams;
+        bool (*resolve)(const ScriptContext&, ScriptCommand&);
+    };
+
+    constexpr Verb VERBS[] = {
+        { "change_camera", EScriptOp::ChangeCamera, 1, 1, &resolveChangeCamera },
+        { "change_room",   EScriptOp::ChangeRoom,   1, 1, &resolveChangeRoom },
+        { "show_info",     EScriptOp::ShowInfo,     0, 1, &resolveShowInfo }
+    };
+
+    const ScriptCommand NO_COMMAND {};
+}
+
+size_t AreaScripts::compile(const RoomDatabase& database, const RoomDatabase::Room& room)
+{
+    clear();
+
+    size_t errors = 0;
+    for(size_t camera = 0; camera < room.getCameraCount(); camera++)
+    {
+        const auto view = room.getCamera(camera);
+        firstCommand_.push_back(static_cast<uint32_t>(commands_.size()));
+
+        for(size_t index = 0; index < view.getAreaCount(); index++)
+        {
+            const auto area = view.getArea(index);
+            auto& command = commands_.emplace_back();
+
+            const auto script = area.getScript();
+            if(script.empty()) continue;
+
+            const auto* verb = std::find_if(std::begin(VERBS), std::end(VERBS), [&](const Verb& verb){ return verb.name == script; });
+            const bool bCompiled = verb != std::end(VERBS)
+                && area.getParamCount() >= verb->minParams
+                && area.getParamCount() <= verb->maxParams
+                && verb->resolve({ database, room, area }, command);
+
+            if(bCompiled)
+            {
+                command.op = verb->op;
+            }
+            else
+            {
+                std::cerr << "Can't compile script \042" << script << "\042 of area " << index << " in camera \042" << view.getName() << "\042\n";
+                command = {};
+                ++errors;
+            }
+        }
+    }
+    firstCommand_.push_back(static_cast<uint32_t>(commands_.size()));
+
+    return errors;
+}
+
+void AreaScripts::clear()
+{
+    commands_.clear();
+    firstCommand_.clear();
+}
+
+const ScriptCommand& AreaScripts::getCommand(size_t camera, size_t area) const
+{
+    if(camera + 1 >= firstCommand_.size()) return NO_COMMAND;
+
+    const size_t command = firstCommand_[camera] + area;
+    return command < firstCommand_[camera + 1] ? commands_[command] : NO_COMMAND;
+}
@@ -0,0 +1,85 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include <scenes/world/room/RoomDatabase.hpp>
+
+namespace lpm
+{
+    enum class EScriptOp : uint8_t
+    {
+        None,               //< Area has no script, or it didn't compile
+        ChangeCamera,       //< change_camera(camera)
+        ChangeRoom,         //< change_room(room)
+        ShowInfo            //< show_info([text]), shows area comment if text is missing
+    };
+
+    /**
+     * @brief Area script with its parameters already resolved.
+     */
+    struct ScriptCommand
+    {
+        EScriptOp op = EScriptOp::None;
+        uint16_t camera = 0;                //< ChangeCamera: index of camera in the room
+        std::string_view text;              //< ChangeRoom: room name, ShowInfo: text. Points into the room database
+    };
+
+    /**
+     * @brief Command table of every area of a room.
+     *
+     * Scripts are named by string in the room database ("change_camera" with params ["AL_Almacen2.jpg"]). compile()
+     * resolves names and params once when the room is entered: verbs are looked up in a table, cameras become
+     * indices and rooms are checked to exist. Running an area script is then a switch on an opcode, with no string
+     * lookup or parsing at click time.
+     *
+     * Scripts that don't compile (unknown verb, wrong params, missing camera or room) are reported and become
+     * EScriptOp::None.
+     */
+    class AreaScripts
+    {
+    public:
+        /**
+         * Compile scripts of every area of the room, replacing previous table
+         * @return Number of scripts that didn't compile
+         */
+        size_t compile(const RoomDatabase& database, const RoomDatabase::Room& room);
+
+        void clear();
+
+    public:
+        /**
+         * Get command of area
+         * @return EScriptOp::None command if camera or area doesn't exist
+         */
+        [[nodiscard]] const ScriptCommand& getCommand(size_t camera, size_t area) const;
+
+        [[nodiscard]] size_t getCommandCount() const { return commands_.size(); }
+
+    private:
+        std::vector<ScriptCommand> commands_;   //< Commands of every area, camera after camera
+        std::vector<uint32_t> firstCommand_;    //< Per camera index of its first command, plus one past the end
+    };
+}
@@ -0,0 +1,364 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "CameraPrefetcher.hpp"
+#include "AreaScripts.hpp"
+#include "RoomTransition.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Texture.hpp>
+
+using namespace lpm;
+
+namespace
+{
+    size_t getImageBytes(sf::Vector2u size)
+    {
+        return static_cast<size_t>(size.x) * size.y * 4;
+    }
+}
+
+CameraPrefetcher::Asset::Asset() = default;
+CameraPrefetcher::Asset::Asset(Asset&&) noexcept = default;
+CameraPrefetcher::Asset& CameraPrefetcher::Asset::operator=(Asset&&) noexcept = default;
+CameraPrefetcher::Asset::~Asset() = default;
+
+CameraPrefetcher::CameraPrefetcher(AsyncLoader& loader, const RoomDatabase& database, const AssetTiers& tiers, size_t budget)
+: loader_(loader)
+, database_(database)
+, tiers_(tiers)
+, budget_(budget)
+, batch_(loader.createBatch())
+{
+}
+
+CameraPrefetcher::~CameraPrefetcher()
+{
+    loader_.cancel(batch_);
+}
+
+void CameraPrefetcher::adopt(RoomContent& content)
+{
+    auto insert = [this](const std::string& file, Asset&& asset){
+        auto [found, bInserted] = assets_.try_emplace(file);
+        auto& existing = found->second;
+
+        // A resident copy may already be drawn, keep it. Loads in flight are superseded, upload skips their result.
+        if(!bInserted && !existing.bLoading && !existing.bFailed) return;
+
+        residentBytes_ -= existing.bytes;
+        residentBytes_ += asset.bytes;
+        asset.lastWanted = existing.lastWanted;
+        release(existing);
+        existing = std::move(asset);
+    };
+
+    for(auto& [file, texture] : content.textures)
+    {
+        Asset asset;
+        asset.bytes = getImageBytes(texture->getSize());
+        asset.texture = std::move(texture);
+        insert(file, std::move(asset));
+    }
+
+    for(auto& [file, mask] : content.masks)
+    {
+        if(!mask) continue;
+
+        Asset asset;
+        asset.bytes = getImageBytes(mask->getSize());
+        asset.mask = std::move(mask);
+        asset.bMask = true;
+        insert(file, std::move(asset));
+    }
+
+    content.textures.clear();
+    content.masks.clear();
+}
+
+void CameraPrefetcher::setRoom(const RoomDatabase::Room& room, const AreaScripts& scripts)
+{
+    room_ = room;
+    neighbours_.clear();
+    firstNeighbour_.clear();
+
+    for(size_t i = 0; i < room.getCameraCount(); i++)
+    {
+        firstNeighbour_.push_back(static_cast<uint32_t>(neighbours_.size()));
+
+        const auto camera = room.getCamera(i);
+        for(size_t area = 0; area < camera.getAreaCount(); area++)
+        {
+            const auto& command = scripts.getCommand(i, area);
+            if(command.op == EScriptOp::ChangeCamera)
+            {
+                neighbours_.push_back({ static_cast<uint16_t>(area), room.getCamera(command.camera) });
+            }
+            else if(command.op == EScriptOp::ChangeRoom)
+            {
+                // Scripts only compile if the room exists, so it was already validated and can't throw
+                if(const auto target = database_.findRoom(command.text); target && target->getCameraCount() > 0)
+                {
+                    neighbours_.push_back({ static_cast<uint16_t>(area), target->getCamera(0) });
+                }
+            }
+        }
+    }
+    firstNeighbour_.push_back(static_cast<uint32_t>(neighbours_.size()));
+
+    cameraIndex_ = 0;
+    hoveredArea_ = AreaMap::NO_AREA;
+    cameraAssets_.assign(room.getCameraCount(), {});
+    wanted_.clear();
+    currentCount_ = nextWanted_ = 0;
+    refreshAssets();
+}
+
+void CameraPrefetcher::setCamera(size_t camera)
+{
+    if(!room_ || camera >= room_->getCameraCount()) return;
+
+    if(cameraAssets_[camera].bResident) hits_++;
+    else misses_++;
+
+    cameraIndex_ = camera;
+    hoveredArea_ = AreaMap::NO_AREA;
+    generation_++;
+    rebuildWanted();
+
+    // Current camera can't wait for the next frame
+    request();
+}
+
+void CameraPrefetcher::setHoveredArea(uint16_t area)
+{
+    if(area == hoveredArea_) return;
+
+    hoveredArea_ = area;
+    if(room_ && cameraIndex_ < room_->getCameraCount()) rebuildWanted();
+}
+
+void CameraPrefetcher::setViewportScale(float scale)
+{
+    viewportScale_ = scale;
+    if(!room_ || cameraIndex_ >= room_->getCameraCount()) return;
+
+    // Background shown keeps its generation, so it isn't evicted before the new tier replaces it
+    rebuildWanted();
+    refreshAssets();
+    request();
+}
+
+AssetTiers::Tier CameraPrefetcher::getBackground(const RoomDatabase::Camera& camera) const
+{
+    return tiers_.select(camera.getName(), viewportScale_);
+}
+
+void CameraPrefetcher::update()
+{
+    upload();
+    evict();
+    request();
+}
+
+bool CameraPrefetcher::isResident(std::string_view file) const
+{
+    const auto asset = assets_.find(std::string(file));
+    return asset != assets_.end() && !asset->second.bLoading;
+}
+
+void CameraPrefetcher::rebuildWanted()
+{
+    wanted_.clear();
+
+    addWanted(room_->getCamera(cameraIndex_));
+    currentCount_ = wanted_.size();
+
+    const auto first = neighbours_.begin() + firstNeighbour_[cameraIndex_];
+    const auto last = neighbours_.begin() + firstNeighbour_[cameraIndex_ + 1];
+
+    for(auto neighbour = first; neighbour != last; ++neighbour)
+    {
+        if(neighbour->area == hoveredArea_) addWanted(neighbour->camera);
+    }
+
+    for(auto neighbour = first; neighbour != last; ++neighbour)
+    {
+        if(neighbour->area != hoveredArea_) addWanted(neighbour->camera);
+    }
+
+    nextWanted_ = 0;
+
+    for(const auto& wanted : wanted_)
+    {
+        if(auto asset = assets_.find(std::string(wanted.file)); asset != assets_.end()) asset->second.lastWanted = generation_;
+    }
+}
+
+void CameraPrefetcher::addWanted(const RoomDatabase::Camera& camera)
+{
+    auto add = [this](std::string_view file, bool bMask){
+        if(!file.empty() && !isWanted(file)) wanted_.push_back({ file, bMask });
+    };
+
+    add(getBackground(camera).file, false);
+    add(camera.getMask(), true);
+
+    for(size_t i = 0; i < camera.getAnimationCount(); i++)
+    {
+        add(camera.getAnimation(i).getSource(), false);
+    }
+}
+
+bool CameraPrefetcher::isWanted(std::string_view file) const
+{
+    return std::ranges::any_of(wanted_, [file](const Wanted& wanted){ return wanted.file == file; });
+}
+
+void CameraPrefetcher::upload()
+{
+    results_.clear();
+    const size_t count = loader_.collect(batch_, results_);
+    if(count == 0) return;
+
+    inFlight_ -= std::min(inFlight_, count);
+
+    for(auto& result : results_)
+    {
+        // Dropped, or adopted from a room transition while it was loading
+        auto found = assets_.find(result.fileName);
+        if(found == assets_.end() || !found->second.bLoading) continue;
+
+        auto& asset = found->second;
+        asset.bLoading = false;
+
+        if(!result.bLoaded)
+        {
+            std::cerr << "Can't load camera image \042" << result.fileName << "\042\n";
+            asset.bFailed = true;
+            continue;
+        }
+
+        asset.bytes = getImageBytes(result.image->getSize());
+        if(asset.bMask)
+        {
+            asset.mask = std::move(result.image);
+        }
+        else if(auto texture = std::make_unique<sf::Texture>(); texture->loadFromImage(*result.image))
+        {
+            asset.texture = std::move(texture);
+        }
+        else
+        {
+            asset.bytes = 0;
+            asset.bFailed = true;
+        }
+        residentBytes_ += asset.bytes;
+    }
+
+    refreshAssets();
+}
+
+void CameraPrefetcher::evict()
+{
+    bool bEvicted = false;
+
+    while(residentBytes_ > budget_)
+    {
+        // Least recently wanted first, files wanted right now are pinned
+        auto victim = assets_.end();
+        for(auto asset = assets_.begin(); asset != assets_.end(); ++asset)
+        {
+            if(asset->second.bLoading || asset->second.lastWanted == generation_) continue;
+            if(victim == assets_.end() || asset->second.lastWanted < victim->second.lastWanted) victim = asset;
+        }
+        if(victim == assets_.end()) break;
+
+        residentBytes_ -= victim->second.bytes;
+        release(victim->second);
+        assets_.erase(victim);
+        bEvicted = true;
+    }
+
+    if(bEvicted) refreshAssets();
+}
+
+void CameraPrefetcher::release(Asset& asset)
+{
+    if(retire_ && asset.texture) retire_(std::move(asset.texture));
+}
+
+void CameraPrefetcher::request()
+{
+    for(; nextWanted_ < wanted_.size() && inFlight_ < MAX_IN_FLIGHT; nextWanted_++)
+    {
+        const auto& wanted = wanted_[nextWanted_];
+
+        // Neighbours wait for room in the budget, the camera being shown doesn't
+        if(nextWanted_ >= currentCount_ && residentBytes_ >= budget_) break;
+
+        auto [asset, bInserted] = assets_.try_emplace(std::string(wanted.file));
+        asset->second.lastWanted = generation_;
+        if(!bInserted) continue;
+
+        asset->second.bMask = wanted.bMask;
+        asset->second.bLoading = true;
+        loader_.load(wanted.file, EAssetType::Image, batch_);
+        inFlight_++;
+    }
+}
+
+void CameraPrefetcher::refreshAssets()
+{
+    for(size_t i = 0; room_ && i < cameraAssets_.size(); i++)
+    {
+        const auto camera = room_->getCamera(i);
+        auto& assets = cameraAssets_[i];
+        assets = {};
+        assets.bResident = true;
+
+        auto find = [&](std::string_view file) -> const Asset* {
+            if(file.empty()) return nullptr;
+
+            const auto asset = assets_.find(std::string(file));
+            if(asset == assets_.end() || asset->second.bLoading)
+            {
+                assets.bResident = false;
+                return nullptr;
+            }
+            return &asset->second;
+        };
+
+        const auto tier = getBackground(camera);
+        assets.scale = tier.scale;
+
+        if(const auto* background = find(tier.file)) assets.background = background->texture.get();
+        if(const auto* mask = find(camera.getMask())) assets.mask = mask->mask.get();
+
+        for(size_t j = 0; j < camera.getAnimationCount(); j++)
+        {
+            find(camera.getAnimation(j).getSource());
+        }
+    }
+}
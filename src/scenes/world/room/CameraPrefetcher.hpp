@@ -0,0 +1,216 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <components/AssetTiers.hpp>
+#include <components/AsyncLoader.hpp>
+#include <components/Delegate.hpp>
+#include <scenes/world/room/AreaMap.hpp>
+#include <scenes/world/room/RoomDatabase.hpp>
+
+namespace sf
+{
+    class Image;
+    class Texture;
+}
+
+namespace lpm
+{
+    class AreaScripts;
+    struct RoomContent;
+
+    /**
+     * @brief Decodes cameras the user can reach with one click before they click.
+     *
+     * Area scripts link cameras together: change_camera leads to another camera of the room and change_room to the
+     * first camera of another room. setRoom() turns the compiled scripts into that navigation graph, and every time
+     * the camera changes the images of its neighbours (background, mask and animations) are queued in the AsyncLoader,
+     * the one behind the hovered area first. When the click comes, the camera is usually already resident.
+     *
+     * Decoded images are kept in a cache limited by budget, counted as 4 bytes per pixel. The current camera and its
+     * neighbours are never evicted, the rest go least recently wanted first. Backgrounds are loaded in the AssetTiers
+     * tier of the viewport scale; after a resize the tier being replaced stays until the camera changes. Neighbours stop being queued when the
+     * budget is full, but images of the current camera are always loaded.
+     */
+    class CameraPrefetcher
+    {
+    public:
+        static constexpr size_t DEFAULT_BUDGET = 96 * 1024 * 1024;
+        static constexpr size_t MAX_IN_FLIGHT  = 2;        //< Requests in the loader at once, so hover can reorder the rest
+
+        using Retire = Delegate<void(std::unique_ptr<sf::Texture>)>;
+
+        /**
+         * Images of a camera of the current room, null until loaded
+         */
+        struct CameraAssets
+        {
+            const sf::Texture* background = nullptr;
+            const sf::Image* mask = nullptr;
+            float scale = 1.f;              //< Background pixels per scene unit
+            bool bResident = false;         //< Every image of the camera finished loading, even if some failed
+        };
+
+    public:
+        CameraPrefetcher(AsyncLoader& loader, const RoomDatabase& database, const AssetTiers& tiers, size_t budget = DEFAULT_BUDGET);
+        ~CameraPrefetcher();
+
+        CameraPrefetcher(const CameraPrefetcher&) = delete;
+        CameraPrefetcher& operator=(const CameraPrefetcher&) = delete;
+
+    public:
+        /**
+         * Take images loaded by a room transition into the cache
+         */
+        void adopt(RoomContent& content);
+
+        /**
+         * Hand textures dropped from the cache to retire instead of freeing them, a frame being drawn may use them
+         */
+        void setRetire(Retire retire) { retire_ = retire; }
+
+        /**
+         * Build navigation graph of room from its compiled scripts
+         */
+        void setRoom(const RoomDatabase::Room& room, const AreaScripts& scripts);
+
+        /**
+         * Set camera being shown, its images are loaded first and its neighbours are prefetched
+         */
+        void setCamera(size_t camera);
+
+        /**
+         * Set area under the mouse, camera behind it is prefetched before other neighbours
+         */
+        void setHoveredArea(uint16_t area);
+
+        /**
+         * Set window pixels per scene unit. Backgrounds of another tier are loaded if it changes.
+         */
+        void setViewportScale(float scale);
+
+        /**
+         * Get tier of camera background for the current viewport scale
+         */
+        [[nodiscard]] AssetTiers::Tier getBackground(const RoomDatabase::Camera& camera) const;
+
+        /**
+         * Upload decoded images, evict over budget and queue more requests. Call it once per frame from the GL thread.
+         */
+        void update();
+
+    public:
+        /**
+         * Check if image is decoded, or already known to be missing
+         */
+        [[nodiscard]] bool isResident(std::string_view file) const;
+
+        /**
+         * Get images of a camera of the current room
+         */
+        [[nodiscard]] const CameraAssets& getAssets(size_t camera) const { return cameraAssets_[camera]; }
+
+        [[nodiscard]] size_t getBudget() const { return budget_; }
+        [[nodiscard]] size_t getResidentBytes() const { return residentBytes_; }
+
+        /**
+         * Camera changes that found the camera resident, and those that had to wait for it
+         */
+        [[nodiscard]] size_t getHits() const { return hits_; }
+        [[nodiscard]] size_t getMisses() const { return misses_; }
+
+    private:
+        struct Asset
+        {
+            std::unique_ptr<sf::Texture> texture;
+            std::unique_ptr<sf::Image> mask;
+            size_t bytes = 0;
+            uint64_t lastWanted = 0;        //< Generation of wanted list that last included it
+            bool bMask = false;
+            bool bLoading = false;
+            bool bFailed = false;
+
+            Asset();
+            Asset(Asset&&) noexcept;
+            Asset& operator=(Asset&&) noexcept;
+            ~Asset();
+        };
+
+        struct Wanted
+        {
+            std::string_view file;          //< Points into the room database or the tiers
+            bool bMask = false;
+        };
+
+        struct Neighbour
+        {
+            uint16_t area;
+            RoomDatabase::Camera camera;
+        };
+
+        void rebuildWanted();
+        void addWanted(const RoomDatabase::Camera& camera);
+        [[nodiscard]] bool isWanted(std::string_view file) const;
+        void upload();
+        void evict();
+        void release(Asset& asset);
+        void request();
+        void refreshAssets();
+
+    private:
+        AsyncLoader& loader_;
+        const RoomDatabase& database_;
+        const AssetTiers& tiers_;
+        const size_t budget_;
+        float viewportScale_ = 1.f;
+        Retire retire_;                                     //< Frees dropped textures if empty
+        uint32_t batch_;
+
+        std::unordered_map<std::string, Asset> assets_;     //< By file name
+        std::vector<AsyncLoader::Result> results_;          //< Reused storage of collected results
+        size_t residentBytes_ = 0;
+        size_t inFlight_ = 0;
+
+        std::optional<RoomDatabase::Room> room_;
+        std::vector<CameraAssets> cameraAssets_;            //< Indexed by camera index in room_
+        std::vector<Neighbour> neighbours_;                 //< Targets of every camera, camera after camera
+        std::vector<uint32_t> firstNeighbour_;              //< Per camera index of its first neighbour, plus one past the end
+
+        size_t cameraIndex_ = 0;
+        uint16_t hoveredArea_ = AreaMap::NO_AREA;
+        std::vector<Wanted> wanted_;                        //< Files by priority, current camera first
+        size_t currentCount_ = 0;                           //< Files of current camera at the start of wanted_
+        size_t nextWanted_ = 0;                             //< Every wanted file before it is resident or loading
+        uint64_t generation_ = 0;                           //< Increased when camera changes, older assets can be evicted
+
+        size_t hits_ = 0;
+        size_t misses_ = 0;
+    };
+}
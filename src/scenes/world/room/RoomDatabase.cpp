@@ -0,0 +1,203 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "RoomDatabase.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include <components/Hash.hpp>
+
+using namespace lpm;
+
+namespace
+{
+    /**
+     * Bounds checks of a room block
+     */
+    class BlockChecker
+    {
+    public:
+        explicit BlockChecker(std::span<const std::byte> block) : block_(block) {}
+
+        template<typename Type>
+        [[nodiscard]] const Type* getArray(uint32_t offset, uint32_t count) const
+        {
+            if(offset % alignof(Type) != 0) return nullptr;
+            if(offset > block_.size() || count > (block_.size() - offset) / sizeof(Type)) return nullptr;
+            return reinterpret_cast<const Type*>(block_.data() + offset);
+        }
+
+        [[nodiscard]] bool checkString(const RoomFormat::String& string, const RoomFormat::Room& room) const
+        {
+            return string.offset <= room.stringsSize && string.length <= room.stringsSize - string.offset;
+        }
+
+    private:
+        std::span<const std::byte> block_;
+    };
+}
+
+RoomDatabase::RoomDatabase(std::string_view fileName)
+{
+    if(!file_.open(fileName)) throw room_exception();
+
+    RoomFormat::Header header {};
+    if(file_.size() < sizeof(header)) throw room_exception();
+    std::memcpy(&header, file_.data(), sizeof(header));
+
+    if(header.magic != RoomFormat::MAGIC || header.version != RoomFormat::VERSION) throw room_exception();
+
+    const BlockChecker checker(file_.getBytes());
+    const auto* entries = checker.getArray<RoomFormat::RoomEntry>(header.indexOffset, header.roomCount);
+    if(!entries) throw room_exception();
+
+    index_ = { entries, header.roomCount };
+    validated_.assign(index_.size(), false);
+
+    for(const auto& entry : index_)
+    {
+        if(entry.offset % RoomFormat::BLOCK_ALIGNMENT != 0 || entry.offset > file_.size() || entry.size > file_.size() - entry.offset)
+        {
+            throw room_exception();
+        }
+    }
+}
+
+std::optional<RoomDatabase::Room> RoomDatabase::findRoom(std::string_view name) const
+{
+    const uint32_t hash = hashName(name);
+
+    // Index is sorted by hash, colliding names are next to each other
+    auto it = std::ranges::lower_bound(index_, hash, {}, &RoomFormat::RoomEntry::nameHash);
+    for(; it != index_.end() && it->nameHash == hash; ++it)
+    {
+        const auto position = static_cast<size_t>(it - index_.begin());
+        const auto block = file_.getBytes().subspan(it->offset, it->size);
+
+        if(!validated_[position])
+        {
+            if(!validateRoom(block)) throw room_exception();
+            validated_[position] = true;
+        }
+
+        const auto* record = reinterpret_cast<const RoomFormat::Room*>(block.data());
+        Room room(block.data(), record, record);
+        if(room.getName() == name) return room;
+    }
+
+    return {};
+}
+
+bool RoomDatabase::validateRoom(std::span<const std::byte> block)
+{
+    const BlockChecker checker(block);
+
+    const auto* room = checker.getArray<RoomFormat::Room>(0, 1);
+    if(!room || !checker.getArray<char>(room->stringsOffset, room->stringsSize)) return false;
+    if(!checker.checkString(room->name, *room) || !checker.checkString(room->music, *room)) return false;
+
+    const auto* cameras = checker.getArray<RoomFormat::Camera>(room->camerasOffset, room->cameraCount);
+    if(!cameras) return false;
+
+    for(const auto& camera : std::span(cameras, room->cameraCount))
+    {
+        if(!checker.checkString(camera.name, *room) || !checker.checkString(camera.mask, *room) || !checker.checkString(camera.sound, *room)) return false;
+
+        const auto* animations = checker.getArray<RoomFormat::Animation>(camera.animationsOffset, camera.animationCount);
+        if(!animations) return false;
+
+        for(const auto& animation : std::span(animations, camera.animationCount))
+        {
+            if(!checker.checkString(animation.name, *room) || !checker.checkString(animation.source, *room)) return false;
+            if(!checker.getArray<RoomFormat::Frame>(animation.framesOffset, animation.frameCount)) return false;
+        }
+
+        const auto* areas = checker.getArray<RoomFormat::Area>(camera.areasOffset, camera.areaCount);
+        if(!areas) return false;
+
+        for(const auto& area : std::span(areas, camera.areaCount))
+        {
+            if(!checker.checkString(area.cursor, *room) || !checker.checkString(area.script, *room) || !checker.checkString(area.comment, *room)) return false;
+            if(!checker.getArray<RoomFormat::Vertex>(area.verticesOffset, area.vertexCount)) return false;
+
+            const auto* params = checker.getArray<RoomFormat::String>(area.paramsOffset, area.paramCount);
+            if(!params) return false;
+
+            for(const auto& param : std::span(params, area.paramCount))
+            {
+                if(!checker.checkString(param, *room)) return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+std::string_view RoomDatabase::Area::getParam(size_t index) const
+{
+    return getString(getArray<RoomFormat::String>(record_->paramsOffset, record_->paramCount)[index]);
+}
+
+RoomDatabase::Animation RoomDatabase::Camera::getAnimation(size_t index) const
+{
+    return { block_, room_, &getArray<RoomFormat::Animation>(record_->animationsOffset, record_->animationCount)[index] };
+}
+
+RoomDatabase::Area RoomDatabase::Camera::getArea(size_t index) const
+{
+    return { block_, room_, &getArray<RoomFormat::Area>(record_->areasOffset, record_->areaCount)[index] };
+}
+
+RoomDatabase::Camera RoomDatabase::Room::getCamera(size_t index) const
+{
+    return { block_, room_, &getArray<RoomFormat::Camera>(record_->camerasOffset, record_->cameraCount)[index] };
+}
+
+std::optional<RoomDatabase::Camera> RoomDatabase::Room::findCamera(std::string_view name) const
+{
+    const uint32_t hash = hashName(name);
+    for(size_t i = 0; i < getCameraCount(); i++)
+    {
+        if(const auto camera = getCamera(i); camera.getNameHash() == hash && camera.getName() == name) return camera;
+    }
+    return {};
+}
+
+void RoomDatabase::Camera::getImages(std::vector<std::string>& images) const
+{
+    images.emplace_back(getName());
+    if(!getMask().empty()) images.emplace_back(getMask());
+
+    for(size_t i = 0; i < getAnimationCount(); i++)
+    {
+        if(const auto source = getAnimation(i).getSource(); !source.empty()) images.emplace_back(source);
+    }
+}
+
+void RoomDatabase::Room::getSounds(std::vector<std::string>& sounds) const
+{
+    if(!getMusic().empty()) sounds.emplace_back(getMusic());
+    for(size_t i = 0; i < getCameraCount(); i++)
+    {
+        if(const auto camera = getCamera(i); !camera.getSound().empty()) sounds.emplace_back(camera.getSound());
+    }
+}
@@ -0,0 +1,183 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <components/MappedFile.hpp>
+#include <scenes/world/room/RoomFormat.hpp>
+
+namespace lpm
+{
+    class room_exception final : public std::exception
+    {
+    };
+
+    /**
+     * @brief Rooms of the world, read from the binary database compiled by RoomCompiler.
+     *
+     * The file is memory mapped and rooms are looked up by name hash in the index. Nothing is decoded up front: views
+     * returned by findRoom read records straight from the mapping, so opening the database and entering a room cost
+     * the same no matter how big the world is, and only pages of visited rooms become resident.
+     *
+     * Views are cheap to copy and valid while the database is alive.
+     */
+    class RoomDatabase
+    {
+    public:
+        /**
+         * Base of views, knows the room block the record lives in
+         */
+        template<typename Record>
+        class View
+        {
+        public:
+            View(const std::byte* block, const RoomFormat::Room* room, const Record* record)
+            : block_(block), room_(room), record_(record)
+            {
+            }
+
+        protected:
+            [[nodiscard]] std::string_view getString(const RoomFormat::String& string) const
+            {
+                return { reinterpret_cast<const char*>(block_ + room_->stringsOffset + string.offset), string.length };
+            }
+
+            template<typename Type>
+            [[nodiscard]] std::span<const Type> getArray(uint32_t offset, uint32_t count) const
+            {
+                return { reinterpret_cast<const Type*>(block_ + offset), count };
+            }
+
+        protected:
+            const std::byte* block_;
+            const RoomFormat::Room* room_;
+            const Record* record_;
+        };
+
+        class Animation : public View<RoomFormat::Animation>
+        {
+        public:
+            using View::View;
+
+            [[nodiscard]] std::string_view getName() const { return getString(record_->name); }
+            [[nodiscard]] std::string_view getSource() const { return getString(record_->source); }
+            [[nodiscard]] float getRate() const { return record_->rate; }
+            [[nodiscard]] int32_t getPosX() const { return record_->posX; }
+            [[nodiscard]] int32_t getPosY() const { return record_->posY; }
+            [[nodiscard]] std::span<const RoomFormat::Frame> getFrames() const { return getArray<RoomFormat::Frame>(record_->framesOffset, record_->frameCount); }
+        };
+
+        class Area : public View<RoomFormat::Area>
+        {
+        public:
+            using View::View;
+
+            [[nodiscard]] std::string_view getCursor() const { return getString(record_->cursor); }
+            [[nodiscard]] std::string_view getScript() const { return getString(record_->script); }
+            [[nodiscard]] size_t getParamCount() const { return record_->paramCount; }
+            [[nodiscard]] std::string_view getParam(size_t index) const;
+            [[nodiscard]] std::span<const RoomFormat::Vertex> getVertices() const { return getArray<RoomFormat::Vertex>(record_->verticesOffset, record_->vertexCount); }
+            [[nodiscard]] uint32_t getDebugColor() const { return record_->debugColor; }
+            [[nodiscard]] std::string_view getComment() const { return getString(record_->comment); }
+        };
+
+        class Camera : public View<RoomFormat::Camera>
+        {
+        public:
+            using View::View;
+
+            [[nodiscard]] std::string_view getName() const { return getString(record_->name); }
+            [[nodiscard]] uint32_t getNameHash() const { return record_->nameHash; }
+            [[nodiscard]] std::string_view getMask() const { return getString(record_->mask); }
+            [[nodiscard]] std::string_view getSound() const { return getString(record_->sound); }
+            [[nodiscard]] unsigned getWidth() const { return record_->width; }
+            [[nodiscard]] unsigned getHeight() const { return record_->height; }
+
+            [[nodiscard]] size_t getAnimationCount() const { return record_->animationCount; }
+            [[nodiscard]] Animation getAnimation(size_t index) const;
+
+            [[nodiscard]] size_t getAreaCount() const { return record_->areaCount; }
+            [[nodiscard]] Area getArea(size_t index) const;
+
+            /**
+             * Append every image needed by the camera: background, mask and animations
+             */
+            void getImages(std::vector<std::string>& images) const;
+        };
+
+        class Room : public View<RoomFormat::Room>
+        {
+        public:
+            using View::View;
+
+            [[nodiscard]] std::string_view getName() const { return getString(record_->name); }
+            [[nodiscard]] std::string_view getMusic() const { return getString(record_->music); }
+
+            [[nodiscard]] size_t getCameraCount() const { return record_->cameraCount; }
+            [[nodiscard]] Camera getCamera(size_t index) const;
+
+            /**
+             * Find camera by name
+             * @return Empty if camera isn't part of the room
+             */
+            [[nodiscard]] std::optional<Camera> findCamera(std::string_view name) const;
+
+            /**
+             * Append every sound needed by the room. Images are listed per camera.
+             */
+            void getSounds(std::vector<std::string>& sounds) const;
+        };
+
+    public:
+        /**
+         * Map database and check its header and index. Room blocks are checked when found.
+         * @throw room_exception if file can't be mapped or isn't a room database
+         */
+        explicit RoomDatabase(std::string_view fileName);
+
+    public:
+        /**
+         * Find room by name
+         * @return Empty if room doesn't exist
+         * @throw room_exception if the room block is corrupt
+         */
+        [[nodiscard]] std::optional<Room> findRoom(std::string_view name) const;
+
+        [[nodiscard]] size_t getRoomCount() const { return index_.size(); }
+
+    private:
+        /**
+         * Check every offset of the room block lies inside it, so views never read out of bounds
+         */
+        [[nodiscard]] static bool validateRoom(std::span<const std::byte> block);
+
+    private:
+        MappedFile file_;
+        std::span<const RoomFormat::RoomEntry> index_;
+        mutable std::vector<bool> validated_;      //< Per index entry, room block already checked
+    };
+}
@@ -0,0 +1,138 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+namespace lpm
+{
+    /**
+     * @brief Binary format of the room database, compiled from rooms.json by RoomCompiler.
+     *
+     * File starts with a Header followed by the room index, one RoomEntry per room sorted by name hash. Each entry
+     * points to a self-contained room block:
+     * - Room record
+     * - Camera records, and the Animation, Frame, Area, String (area params) and Vertex arrays they point to
+     * - String pool of the room
+     *
+     * Every offset inside a block is relative to the start of the block, and every String is relative to the string
+     * pool of its room, so a room is read touching only its own pages. Records are plain little-endian structs aligned
+     * to 4 bytes, meant to be read straight from a memory mapped file.
+     */
+    namespace RoomFormat
+    {
+        static constexpr uint32_t MAGIC   = 0x44524C4C; // "LLRD"
+        static constexpr uint16_t VERSION = 1;
+        static constexpr uint32_t BLOCK_ALIGNMENT = 16;
+
+        struct String
+        {
+            uint32_t offset;
+            uint32_t length;
+        };
+
+        struct Header
+        {
+            uint32_t magic;
+            uint16_t version;
+            uint16_t reserved;
+            uint32_t roomCount;
+            uint32_t indexOffset;                   //< Offset of RoomEntry array from file start
+        };
+
+        struct RoomEntry
+        {
+            uint32_t nameHash;                      //< hashName of the room name, entries are sorted by it
+            uint32_t offset;                        //< Offset of room block from file start
+            uint32_t size;                          //< Size of room block
+        };
+
+        struct Room
+        {
+            String name;
+            String music;                           //< Empty if room has no music
+            uint32_t cameraCount;
+            uint32_t camerasOffset;
+            uint32_t stringsOffset;                 //< Offset of string pool
+            uint32_t stringsSize;
+        };
+
+        struct Camera
+        {
+            uint32_t nameHash;
+            String name;                            //< Also the file of its background
+            String mask;                            //< Empty if camera has no mask
+            String sound;                           //< Empty if camera has no background sound
+            uint16_t width;
+            uint16_t height;
+            uint32_t animationCount;
+            uint32_t animationsOffset;
+            uint32_t areaCount;
+            uint32_t areasOffset;
+        };
+
+        struct Animation
+        {
+            uint32_t nameHash;
+            String name;
+            String source;
+            float rate;
+            int32_t posX;
+            int32_t posY;
+            uint32_t frameCount;
+            uint32_t framesOffset;
+        };
+
+        struct Frame
+        {
+            uint16_t x;
+            uint16_t y;
+            uint16_t w;
+            uint16_t h;
+        };
+
+        struct Area
+        {
+            String cursor;
+            String script;                          //< Empty if area has no script
+            uint32_t paramCount;
+            uint32_t paramsOffset;                  //< Array of String
+            uint32_t vertexCount;
+            uint32_t verticesOffset;
+            uint32_t debugColor;                    //< RGBA
+            String comment;
+        };
+
+        struct Vertex
+        {
+            uint16_t x;
+            uint16_t y;
+        };
+
+        template<typename Record>
+        inline constexpr bool IS_RECORD = std::is_trivially_copyable_v<Record> && alignof(Record) <= 4 && sizeof(Record) % 4 == 0;
+
+        static_assert(IS_RECORD<Header> && IS_RECORD<RoomEntry> && IS_RECORD<Room> && IS_RECORD<Camera>);
+        static_assert(IS_RECORD<Animation> && IS_RECORD<Frame> && IS_RECORD<Area> && IS_RECORD<Vertex> && IS_RECORD<String>);
+    }
+}
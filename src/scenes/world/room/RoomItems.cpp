@@ -0,0 +1,170 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "RoomItems.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+#include <components/Hash.hpp>
+
+using namespace lpm;
+
+namespace
+{
+    constexpr uint32_t EMPTY_SERVER_ID = std::numeric_limits<uint32_t>::max();
+}
+
+RoomItems::RoomItems(size_t capacity)
+: pool_(capacity)
+, positions_(capacity)
+, denseKinds_(capacity, INVALID_KIND)
+, serverIds_(capacity, EMPTY_SERVER_ID)
+, index_(capacity)
+{
+    kinds_.reserve(MAX_KINDS);
+    pendingDestroys_.reserve(capacity);
+}
+
+RoomItemID RoomItems::spawn(uint32_t serverId, std::string_view kind, sf::Vector2f position)
+{
+    assert(serverId != EMPTY_SERVER_ID && "Server id reserved by RoomItems");
+
+    const uint16_t kindIndex = findOrAddKind(kind);
+    if(kindIndex == INVALID_KIND) return {};
+
+    auto item = find(serverId);
+    if(item.isValid())
+    {
+        // Respawned before destruction was flushed, keep it
+        std::erase(pendingDestroys_, item);
+    }
+    else
+    {
+        item = pool_.acquire();
+        if(!item.isValid()) return {};
+
+        serverIds_[item.index] = serverId;
+        index_.insert(serverId, item.index);
+    }
+
+    const auto dense = pool_.getDenseIndex(item);
+    positions_[dense]  = position;
+    denseKinds_[dense] = kindIndex;
+
+    return item;
+}
+
+void RoomItems::destroyLater(RoomItemID item)
+{
+    if(isValid(item) && pendingDestroys_.size() < pendingDestroys_.capacity())
+    {
+        pendingDestroys_.push_back(item);
+    }
+}
+
+size_t RoomItems::flushDestroyed()
+{
+    size_t destroyed = 0;
+    for(const auto item : pendingDestroys_)
+    {
+        // Same item may be queued twice, only the first one is alive
+        if(isValid(item))
+        {
+            destroy(item);
+            ++destroyed;
+        }
+    }
+    pendingDestroys_.clear();
+    return destroyed;
+}
+
+void RoomItems::clear()
+{
+    pendingDestroys_.clear();
+    while(size() > 0)
+    {
+        destroy(getItemAt(size() - 1));
+    }
+}
+
+RoomItemID RoomItems::find(uint32_t serverId) const
+{
+    const auto slot = index_.find(serverId);
+    return slot != ServerIDIndex::INVALID_SLOT ? pool_.getSlotHandle(slot) : RoomItemID{};
+}
+
+uint32_t RoomItems::getServerID(RoomItemID item) const
+{
+    assert(isValid(item) && "Trying to get an invalid item");
+    return serverIds_[item.index];
+}
+
+sf::Vector2f RoomItems::getPosition(RoomItemID item) const
+{
+    assert(isValid(item) && "Trying to get an invalid item");
+    return positions_[pool_.getDenseIndex(item)];
+}
+
+uint16_t RoomItems::getKind(RoomItemID item) const
+{
+    assert(isValid(item) && "Trying to get an invalid item");
+    return denseKinds_[pool_.getDenseIndex(item)];
+}
+
+std::string_view RoomItems::getKindName(uint16_t kind) const
+{
+    assert(kind < kinds_.size() && "Trying to get an unknown kind");
+    return { kinds_[kind].name, kinds_[kind].length };
+}
+
+uint16_t RoomItems::findOrAddKind(std::string_view kind)
+{
+    const uint32_t hash = hashName(kind);
+
+    const auto name = kind.substr(0, Kind::MAX_NAME);
+
+    // Few kinds per room, a linear scan of hashes beats any map. Names are compared too, hashes may collide.
+    for(size_t i = 0; i < kinds_.size(); i++)
+    {
+        if(kinds_[i].hash == hash && getKindName(static_cast<uint16_t>(i)) == name) return static_cast<uint16_t>(i);
+    }
+
+    if(kinds_.size() == MAX_KINDS) return INVALID_KIND;
+
+    auto& added = kinds_.emplace_back();
+    added.hash   = hash;
+    added.length = static_cast<uint8_t>(name.size());
+    std::copy_n(name.data(), added.length, added.name);
+
+    return static_cast<uint16_t>(kinds_.size() - 1);
+}
+
+void RoomItems::destroy(RoomItemID item)
+{
+    index_.erase(serverIds_[item.index]);
+    serverIds_[item.index] = EMPTY_SERVER_ID;
+
+    // Mirror the dense swap made by the pool
+    const auto [dense, moved] = pool_.release(item);
+    positions_[dense]  = positions_[moved];
+    denseKinds_[dense] = denseKinds_[moved];
+}
@@ -0,0 +1,129 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <SFML/System/Vector2.hpp>
+
+#include <components/HandlePool.hpp>
+#include <components/ServerIDIndex.hpp>
+
+namespace lpm
+{
+    struct RoomItem;
+    using RoomItemID = Handle<RoomItem>;
+
+    /**
+     * @brief Pool of items lying in the current room.
+     *
+     * Items are referenced by generational RoomItemID, so a handle kept after the item was picked up or destroyed by
+     * the server is detected instead of pointing to whatever item reused the slot. Positions and kinds are packed by
+     * dense index for drawing, server ids are resolved with an open addressing table.
+     *
+     * Destruction is deferred until flushDestroyed(), so an item destroyed while the room is ticking or drawing stays
+     * readable until the frame ends. All memory is reserved on construction: spawning and destroying never allocate.
+     */
+    class RoomItems
+    {
+    public:
+        static constexpr size_t DEFAULT_CAPACITY = 512;
+        static constexpr size_t MAX_KINDS        = 64;
+        static constexpr uint16_t INVALID_KIND   = 0xFFFF;
+
+    public:
+        explicit RoomItems(size_t capacity = DEFAULT_CAPACITY);
+
+    public:
+        /**
+         * Spawn item, or move the existing one if serverId is already spawned
+         * @param kind Name of the item, shared by every item drawn the same way
+         * @return RoomItemID of the item, invalid if pool or kind table is full
+         */
+        RoomItemID spawn(uint32_t serverId, std::string_view kind, sf::Vector2f position);
+
+        /**
+         * Destroy item at the end of the frame. RoomItemID stays valid until flushDestroyed().
+         */
+        void destroyLater(RoomItemID item);
+
+        /**
+         * Destroy items queued with destroyLater
+         * @return Number of items destroyed
+         */
+        size_t flushDestroyed();
+
+        /**
+         * Destroy every item right away. Kinds are kept.
+         */
+        void clear();
+
+    public:
+        [[nodiscard]] RoomItemID find(uint32_t serverId) const;
+        [[nodiscard]] bool isValid(RoomItemID item) const { return pool_.isAlive(item); }
+        [[nodiscard]] uint32_t getServerID(RoomItemID item) const;
+        [[nodiscard]] sf::Vector2f getPosition(RoomItemID item) const;
+        [[nodiscard]] uint16_t getKind(RoomItemID item) const;
+
+        [[nodiscard]] size_t size() const { return pool_.size(); }
+        [[nodiscard]] size_t capacity() const { return pool_.capacity(); }
+
+        /**
+         * Kinds seen so far, indexed by the values returned by getKind
+         */
+        [[nodiscard]] size_t getKindCount() const { return kinds_.size(); }
+        [[nodiscard]] std::string_view getKindName(uint16_t kind) const;
+
+        /**
+         * Hot arrays, all of them indexed by the same dense index in [0, size())
+         */
+        [[nodiscard]] RoomItemID getItemAt(size_t dense) const { return pool_.getHandle(dense); }
+        [[nodiscard]] std::span<const sf::Vector2f> getPositions() const { return { positions_.data(), size() }; }
+        [[nodiscard]] std::span<const uint16_t> getKinds() const { return { denseKinds_.data(), size() }; }
+
+    private:
+        struct Kind
+        {
+            static constexpr size_t MAX_NAME = 31;
+
+            uint32_t hash = 0;
+            uint8_t length = 0;
+            char name[MAX_NAME] {};
+        };
+
+    private:
+        [[nodiscard]] uint16_t findOrAddKind(std::string_view kind);
+        void destroy(RoomItemID item);
+
+    private:
+        HandlePool<RoomItem> pool_;
+        std::vector<sf::Vector2f> positions_;   //< Indexed by dense index
+        std::vector<uint16_t> denseKinds_;     //< Indexed by dense index
+        std::vector<uint32_t> serverIds_;       //< Indexed by slot
+        std::vector<Kind> kinds_;
+        ServerIDIndex index_;                   //< Server id to slot
+        std::vector<RoomItemID> pendingDestroys_;
+    };
+}
@@ -20,26 +20,254 @@
 // WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "RoomSceneNode.hpp"
+#include "AreaMap.hpp"
+#include "AreaScripts.hpp"
+#include "CameraPrefetcher.hpp"
 #include "RoomCamera.hpp"
+#include "RoomDatabase.hpp"
+#include "RoomTransition.hpp"
+
+#include <iostream>
 
 #include <SFML/Audio/Sound.hpp>
+#include <SFML/Audio/SoundBuffer.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Window/Mouse.hpp>
+
+#include <chat/ChatLog.hpp>
+#include <network/InterestManager.hpp>
+#include <scene/RenderQueue.hpp>
+#include <scene/Scene.hpp>
+#include <Engine.hpp>
+#include <Configuration.hpp>
+#include <widgets/Cursor.hpp>
 
 using namespace lpm;
 
-RoomSceneNode::RoomSceneNode()
-: roomName_("Default Room")
+RoomSceneNode::RoomSceneNode(InterestManager* interest)
+: interest_(interest)
+, background_(std::make_unique<sf::Sprite>())
+, roomName_("Default Room")
 , soundPlayer_(std::make_unique<sf::Sound>())
+, areas_(std::make_unique<AreaMap>())
+, scripts_(std::make_unique<AreaScripts>())
+, hoveredArea_(AreaMap::NO_AREA)
+, pressedArea_(AreaMap::NO_AREA)
 {
 }
 
 RoomSceneNode::~RoomSceneNode() = default;
 
+void RoomSceneNode::init()
+{
+    try
+    {
+        database_ = std::make_unique<RoomDatabase>(Configuration::ROOM_DATABASE_FILE);
+    }
+    catch(const room_exception&)
+    {
+        std::cerr << "Can't read rooms from \042" << Configuration::ROOM_DATABASE_FILE << "\042\n";
+        return;
+    }
+
+    auto* engine = getSceneOwner()->getEngine();
+    prefetcher_ = std::make_unique<CameraPrefetcher>(engine->getLoader(), *database_, engine->getTiers());
+    prefetcher_->setViewportScale(engine->getViewportScale());
+    prefetcher_->setRetire(CameraPrefetcher::Retire::bind<&Scene::retire>(getSceneOwner()));
+    transition_ = std::make_unique<RoomTransition>(engine->getNetwork(), engine->getLoader(), *database_, *prefetcher_);
+}
+
+bool RoomSceneNode::changeRoom(std::string_view name)
+{
+    return transition_ && transition_->begin(name);
+}
+
+void RoomSceneNode::changeCamera(std::string_view name)
+{
+    for(size_t camera = 0; room_ && camera < room_->getCameraCount(); camera++)
+    {
+        if(room_->getCamera(camera).getName() == name)
+        {
+            setCamera(camera);
+            return;
+        }
+    }
+}
+
+void RoomSceneNode::findAreas(std::span<const sf::Vector2f> points, std::span<uint16_t> areas) const
+{
+    areas_->find(points, areas);
+}
+
 void RoomSceneNode::tick(float deltaTime)
 {
-    deltaTime++;
+    if(transition_ && transition_->update(deltaTime) == RoomTransition::EStatus::Committed)
+    {
+        commitRoom();
+    }
+
+    if(prefetcher_)
+    {
+        prefetcher_->update();
+        if(bCameraPending_ && prefetcher_->getAssets(cameraIndex_).bResident) applyCamera();
+    }
+
+    const auto mouse = getSceneOwner()->getSceneMousePos();
+    const auto area = areas_->find(mouse.x, mouse.y);
+    if(area != hoveredArea_) setHoveredArea(area);
+
+    // Scripts run when the button is released over the area it was pressed on, like buttons
+    const bool bMouseDown = sf::Mouse::isButtonPressed(sf::Mouse::Left);
+    if(bMouseDown && !bMouseDown_)
+    {
+        pressedArea_ = area;
+    }
+    else if(!bMouseDown && bMouseDown_ && area == pressedArea_ && area != AreaMap::NO_AREA)
+    {
+        runScript(scripts_->getCommand(cameraIndex_, area));
+    }
+    bMouseDown_ = bMouseDown;
+}
+
+void RoomSceneNode::resize()
+{
+    if(!prefetcher_) return;
+
+    prefetcher_->setViewportScale(getSceneOwner()->getEngine()->getViewportScale());
+
+    // Background of the previous tier is drawn until the new one arrives
+    if(cameraIndex_ != NO_CAMERA && !prefetcher_->getAssets(cameraIndex_).bResident) bCameraPending_ = true;
 }
 
-void RoomSceneNode::draw([[maybe_unused]]sf::RenderTarget& target, [[maybe_unused]]sf::RenderStates states) const
+void RoomSceneNode::destroy()
 {
-    
+    // Don't leave the cursor pointing to a name of the database
+    setHoveredArea(AreaMap::NO_AREA);
+}
+
+void RoomSceneNode::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+    if(background_->getTexture()) target.draw(*background_, states);
+}
+
+void RoomSceneNode::submit(RenderQueue& queue, const sf::RenderStates& states) const
+{
+    if(background_->getTexture()) queue.submit(*background_, states, getSceneNodeID());
+}
+
+void RoomSceneNode::commitRoom()
+{
+    // Sound, background and areas may still use assets of the room being replaced
+    soundPlayer_->stop();
+    *background_ = sf::Sprite();
+    invalidate();
+    areas_->clear();
+    scripts_->clear();
+    setHoveredArea(AreaMap::NO_AREA);
+    cameraSounds_.clear();
+    cameraIndex_ = NO_CAMERA;
+    bCameraPending_ = false;
+
+    content_ = transition_->takeContent();
+    roomName_ = content_->name;
+    prefetcher_->adopt(*content_);
+
+    // Already validated by the transition, it can't throw
+    room_ = database_->findRoom(roomName_);
+    if(!room_) return;
+
+    for(size_t i = 0; i < room_->getCameraCount(); i++)
+    {
+        const auto sound = content_->sounds.find(std::string(room_->getCamera(i).getSound()));
+        cameraSounds_.push_back(sound != content_->sounds.end() ? sound->second.get() : nullptr);
+    }
+
+    scripts_->compile(*database_, *room_);
+    prefetcher_->setRoom(*room_, *scripts_);
+
+    if(room_->getCameraCount() > 0) setCamera(0);
+}
+
+void RoomSceneNode::setCamera(size_t camera)
+{
+    cameraIndex_ = camera;
+    interest_->changeCamera(room_->getCamera(camera).getName());
+
+    soundPlayer_->stop();
+    if(const auto* sound = cameraSounds_[camera])
+    {
+        soundPlayer_->setBuffer(*sound);
+        soundPlayer_->setLoop(true);
+        soundPlayer_->play();
+    }
+
+    // Don't keep pointing to a texture of another camera, prefetcher may evict it
+    *background_ = sf::Sprite();
+    invalidate();
+    areas_->clear();
+    setHoveredArea(AreaMap::NO_AREA);
+
+    prefetcher_->setCamera(camera);
+    if(prefetcher_->getAssets(camera).bResident) applyCamera();
+    else bCameraPending_ = true;
+}
+
+void RoomSceneNode::applyCamera()
+{
+    const auto view = room_->getCamera(cameraIndex_);
+    const auto& assets = prefetcher_->getAssets(cameraIndex_);
+    bCameraPending_ = false;
+
+    if(assets.background)
+    {
+        background_->setTexture(*assets.background, true);
+        background_->setScale(1.f / assets.scale, 1.f / assets.scale);
+        invalidate();
+    }
+
+    // Painted masks are more precise than polygons, polygons are the fallback
+    if(assets.mask) areas_->loadMask(*assets.mask, view);
+    else areas_->rasterize(view);
+}
+
+void RoomSceneNode::setHoveredArea(uint16_t area)
+{
+    const bool bWasHovering = hoveredArea_ != AreaMap::NO_AREA;
+    hoveredArea_ = area;
+    if(prefetcher_) prefetcher_->setHoveredArea(area);
+
+    // Cursor names live in the mapped database, which outlives the cursor using them
+    std::string_view cursor;
+    if(area != AreaMap::NO_AREA && room_ && cameraIndex_ != NO_CAMERA)
+    {
+        cursor = room_->getCamera(cameraIndex_).getArea(area).getCursor();
+    }
+
+    if(!cursor.empty() || bWasHovering)
+    {
+        getSceneOwner()->getEngine()->getCursor().setCursor(cursor.empty() ? "default" : cursor);
+    }
+}
+
+void RoomSceneNode::runScript(const ScriptCommand& command)
+{
+    switch(command.op)
+    {
+        case EScriptOp::None:
+            break;
+
+        case EScriptOp::ChangeCamera:
+            setCamera(command.camera);
+            break;
+
+        case EScriptOp::ChangeRoom:
+            changeRoom(command.text);
+            break;
+
+        case EScriptOp::ShowInfo:
+            getSceneOwner()->getEngine()->getChat().push(EChatChannel::Room, {}, command.text);
+            break;
+    }
 }
@@ -22,32 +22,106 @@
 #pragma once
 
 #include <scene/SceneNode.hpp>
+#include <cstdint>
 #include <memory>
-#include <vector>
+#include <optional>
+#include <span>
 #include <string>
+#include <vector>
+
+#include <SFML/System/Vector2.hpp>
+
+#include <scenes/world/room/RoomDatabase.hpp>
 
 namespace sf
 {
+    class Image;
     class Sound;
+    class SoundBuffer;
+    class Sprite;
+    class Texture;
 }
 
 namespace lpm
 {
+    class AreaMap;
+    class AreaScripts;
+    class CameraPrefetcher;
+    class InterestManager;
+    class RoomTransition;
+    struct RoomContent;
+    struct ScriptCommand;
+
     class RoomSceneNode : public SceneNode
     {
         using RoomCameraPtr = std::unique_ptr<class RoomCamera>;
 
     public:
-        RoomSceneNode();
+        explicit RoomSceneNode(InterestManager* interest);
         ~RoomSceneNode() override;
 
+    public:
+        /**
+         * Move to room. Assets stream while the server answers, current room is shown until both finish.
+         * @return False if room doesn't exist
+         */
+        bool changeRoom(std::string_view name);
+
+        /**
+         * Set camera the local player is looking at. Remote players outside it are downgraded to presence.
+         * Ignored if camera isn't part of the current room.
+         */
+        void changeCamera(std::string_view name);
+
+        /**
+         * Get area of the current camera under the mouse
+         * @return Area index, AreaMap::NO_AREA if none
+         */
+        [[nodiscard]] uint16_t getHoveredArea() const { return hoveredArea_; }
+
+        /**
+         * Get areas of the current camera under many points at once, e.g. every remote cursor
+         */
+        void findAreas(std::span<const sf::Vector2f> points, std::span<uint16_t> areas) const;
+
     protected:
+        void init() override;
         void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+        void submit(RenderQueue& queue, const sf::RenderStates& states) const override;
         void tick(float deltaTime) override;
+        void resize() override;
+        void destroy() override;
+
+    private:
+        static constexpr size_t NO_CAMERA = static_cast<size_t>(-1);
+
+        void commitRoom();
+        void setCamera(size_t camera);
+        void applyCamera();
+        void setHoveredArea(uint16_t area);
+        void runScript(const ScriptCommand& command);
 
     private:
+        InterestManager* interest_;
+
+        std::unique_ptr<RoomDatabase> database_;
+        std::unique_ptr<CameraPrefetcher> prefetcher_;  //< Owns camera images
+        std::unique_ptr<RoomTransition> transition_;
+        std::unique_ptr<RoomContent> content_;      //< Sounds of current room
+        std::unique_ptr<sf::Sprite> background_;
+
         std::string roomName_;
+        std::optional<RoomDatabase::Room> room_;    //< Current room, empty until first one is committed
+        std::vector<const sf::SoundBuffer*> cameraSounds_;  //< Indexed by camera index in room_
+        size_t cameraIndex_ = NO_CAMERA;
+        bool bCameraPending_ = false;               //< Camera is set but its images are still loading
         std::vector<RoomCameraPtr> cameras_;
         std::unique_ptr<sf::Sound> soundPlayer_;
+
+        std::unique_ptr<AreaMap> areas_;            //< Areas of current camera
+        std::unique_ptr<AreaScripts> scripts_;      //< Commands of every area of room_
+        uint16_t hoveredArea_;
+        uint16_t pressedArea_;                      //< Area under mouse when left button was pressed
+        bool bMouseDown_ = false;
     };
 }
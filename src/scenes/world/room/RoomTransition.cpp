@@ -0,0 +1,221 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "RoomTransition.hpp"
+#include "CameraPrefetcher.hpp"
+#include "RoomDatabase.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Audio/SoundBuffer.hpp>
+
+#include <network/INetwork.hpp>
+
+using namespace lpm;
+
+RoomContent::RoomContent() = default;
+RoomContent::~RoomContent() = default;
+
+RoomTransition::RoomTransition(INetwork& network, AsyncLoader& loader, const RoomDatabase& database, const CameraPrefetcher& prefetcher)
+: network_(network)
+, loader_(loader)
+, database_(database)
+, prefetcher_(prefetcher)
+{
+    subscription_ = network_.getEvents().subscribe<NetworkEvent::RoomChanged>(
+        NetworkEventBus::Handler<NetworkEvent::RoomChanged>::bind<&RoomTransition::onRoomChanged>(this)
+    );
+}
+
+RoomTransition::~RoomTransition()
+{
+    network_.getEvents().unsubscribe(subscription_);
+    cancel();
+}
+
+bool RoomTransition::begin(std::string_view room)
+{
+    std::optional<RoomDatabase::Room> found;
+    try
+    {
+        found = database_.findRoom(room);
+    }
+    catch(const room_exception&)
+    {
+        std::cerr << "Room \042" << room << "\042 is corrupt in the room database\n";
+        return false;
+    }
+    if(!found) return false;
+
+    cancel();
+
+    content_ = std::make_unique<RoomContent>();
+    content_->name = found->getName();
+
+    std::vector<std::string> images;
+    std::vector<std::string> sounds;
+    found->getSounds(sounds);
+
+    if(found->getCameraCount() > 0)
+    {
+        const auto camera = found->getCamera(0);
+        camera.getImages(images);
+        images.front() = prefetcher_.getBackground(camera).file;
+
+        // Usually prefetched while hovering the area that leads here
+        std::erase_if(images, [this](const std::string& image){ return prefetcher_.isResident(image); });
+
+        if(const auto mask = camera.getMask(); !mask.empty() && !prefetcher_.isResident(mask))
+        {
+            content_->masks.try_emplace(std::string(mask));
+        }
+    }
+
+    // Cameras can share sounds and animations
+    for(auto* files : { &images, &sounds })
+    {
+        std::sort(files->begin(), files->end());
+        files->erase(std::unique(files->begin(), files->end()), files->end());
+    }
+
+    // Assets start streaming before the request leaves, so both run at the same time
+    batch_ = loader_.createBatch();
+    for(const auto& image : images) loader_.load(image, EAssetType::Image, batch_);
+    for(const auto& sound : sounds) loader_.load(sound, EAssetType::Sound, batch_);
+    expected_ = images.size() + sounds.size();
+    received_ = 0;
+
+    time_ = serverTime_ = loadTime_ = 0.f;
+    bAnswered_ = bAccepted_ = bDone_ = false;
+
+    network_.changeRoom(content_->name);
+    return true;
+}
+
+void RoomTransition::cancel()
+{
+    if(!content_) return;
+
+    loader_.cancel(batch_);
+    content_.reset();
+    batch_ = 0;
+    bDone_ = false;
+}
+
+RoomTransition::EStatus RoomTransition::update(float deltaTime)
+{
+    if(!isPending()) return EStatus::Idle;
+
+    time_ += deltaTime;
+    upload();
+
+    if(received_ == expected_ && loadTime_ == 0.f) loadTime_ = time_;
+
+    if(bAnswered_ && !bAccepted_)
+    {
+        rollback();
+        return EStatus::RolledBack;
+    }
+
+    if(!bAnswered_ && time_ > SERVER_TIMEOUT)
+    {
+        std::cerr << "Server didn't answer change to room \042" << content_->name << "\042\n";
+        rollback();
+        return EStatus::RolledBack;
+    }
+
+    if(bAccepted_ && received_ == expected_)
+    {
+        lastServerTime_ = serverTime_;
+        lastLoadTime_ = loadTime_;
+        lastTotalTime_ = time_;
+        bDone_ = true;
+        return EStatus::Committed;
+    }
+
+    return EStatus::Pending;
+}
+
+std::unique_ptr<RoomContent> RoomTransition::takeContent()
+{
+    if(!bDone_) return {};
+
+    bDone_ = false;
+    batch_ = 0;
+    return std::move(content_);
+}
+
+std::string_view RoomTransition::getPendingRoom() const
+{
+    return isPending() ? std::string_view(content_->name) : std::string_view();
+}
+
+void RoomTransition::onRoomChanged(const NetworkEvent::RoomChanged& event)
+{
+    if(!isPending() || bAnswered_ || event.room != content_->name) return;
+
+    bAnswered_ = true;
+    bAccepted_ = event.accepted;
+    serverTime_ = time_;
+}
+
+void RoomTransition::upload()
+{
+    results_.clear();
+    received_ += loader_.collect(batch_, results_);
+
+    for(auto& result : results_)
+    {
+        if(!result.bLoaded)
+        {
+            std::cerr << "Can't load room asset \042" << result.fileName << "\042\n";
+            continue;
+        }
+
+        switch(result.type)
+        {
+            case EAssetType::Image:
+                if(auto mask = content_->masks.find(result.fileName); mask != content_->masks.end())
+                {
+                    mask->second = std::move(result.image);
+                }
+                else if(auto texture = std::make_unique<sf::Texture>(); texture->loadFromImage(*result.image))
+                {
+                    content_->textures.try_emplace(result.fileName, std::move(texture));
+                }
+                break;
+
+            case EAssetType::Sound:
+                content_->sounds.try_emplace(result.fileName, std::move(result.sound));
+                break;
+        }
+    }
+    results_.clear();
+}
+
+void RoomTransition::rollback()
+{
+    std::cerr << "Change to room \042" << content_->name << "\042 rolled back\n";
+    cancel();
+}
@@ -0,0 +1,155 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <components/AsyncLoader.hpp>
+#include <network/NetworkEvents.hpp>
+
+namespace sf
+{
+    class Image;
+    class Texture;
+    class SoundBuffer;
+}
+
+namespace lpm
+{
+    class CameraPrefetcher;
+    class INetwork;
+    class RoomDatabase;
+
+    /**
+     * @brief Assets of a loaded room, keyed by file name.
+     */
+    struct RoomContent
+    {
+        std::string name;
+        std::unordered_map<std::string, std::unique_ptr<sf::Texture>> textures;
+        std::unordered_map<std::string, std::unique_ptr<sf::SoundBuffer>> sounds;
+        std::unordered_map<std::string, std::unique_ptr<sf::Image>> masks;     //< Area masks stay on CPU, null if missing
+
+        RoomContent();
+        ~RoomContent();
+    };
+
+    /**
+     * @brief Room change that overlaps the server round trip with asset streaming.
+     *
+     * begin() asks the server for the room and, at the same time, queues the assets of the room in the AsyncLoader: every
+     * sound and the images of the first camera, unless the CameraPrefetcher already has them. Other cameras are left
+     * to the prefetcher.
+     * The transition commits when the server accepted it and every asset is ready, so the user waits
+     * max(network, load) instead of their sum. If the server refuses, or doesn't answer in SERVER_TIMEOUT seconds,
+     * the transition rolls back: pending loads are cancelled and the current room is kept.
+     *
+     * Assets that fail to load don't stop the transition, they're just missing from RoomContent.
+     */
+    class RoomTransition
+    {
+    public:
+        static constexpr float SERVER_TIMEOUT = 10.f;
+
+        enum class EStatus : uint8_t
+        {
+            Idle,           //< No transition in progress
+            Pending,        //< Waiting for server, assets or both
+            Committed,      //< Finished this frame, content can be taken
+            RolledBack      //< Refused this frame, current room stays
+        };
+
+    public:
+        RoomTransition(INetwork& network, AsyncLoader& loader, const RoomDatabase& database, const CameraPrefetcher& prefetcher);
+        ~RoomTransition();
+
+        RoomTransition(const RoomTransition&) = delete;
+        RoomTransition& operator=(const RoomTransition&) = delete;
+
+    public:
+        /**
+         * Start changing to room. A transition already in progress is abandoned.
+         * @return False if room isn't in the database
+         */
+        bool begin(std::string_view room);
+
+        /**
+         * Abandon transition in progress
+         */
+        void cancel();
+
+        /**
+         * Upload decoded assets and check if transition finished. Call it once per frame from the GL thread.
+         */
+        EStatus update(float deltaTime);
+
+        /**
+         * Take assets of a committed transition
+         */
+        [[nodiscard]] std::unique_ptr<RoomContent> takeContent();
+
+    public:
+        [[nodiscard]] bool isPending() const { return content_ && !bDone_; }
+        [[nodiscard]] std::string_view getPendingRoom() const;
+
+        /**
+         * Seconds the last committed transition waited for the server, for assets, and in total
+         */
+        [[nodiscard]] float getLastServerTime() const { return lastServerTime_; }
+        [[nodiscard]] float getLastLoadTime() const { return lastLoadTime_; }
+        [[nodiscard]] float getLastTotalTime() const { return lastTotalTime_; }
+
+    private:
+        void onRoomChanged(const NetworkEvent::RoomChanged& event);
+        void upload();
+        void rollback();
+
+    private:
+        INetwork& network_;
+        AsyncLoader& loader_;
+        const RoomDatabase& database_;
+        const CameraPrefetcher& prefetcher_;
+        NetworkEventBus::Subscription subscription_;
+
+        std::unique_ptr<RoomContent> content_;      //< Room being built, null if idle
+        std::vector<AsyncLoader::Result> results_;  //< Reused storage of collected results
+        uint32_t batch_ = 0;
+        size_t expected_ = 0;                       //< Assets requested
+        size_t received_ = 0;                       //< Assets collected, loaded or not
+
+        float time_ = 0.f;
+        float serverTime_ = 0.f;
+        float loadTime_ = 0.f;
+        bool bAnswered_ = false;
+        bool bAccepted_ = false;
+        bool bDone_ = false;                        //< Committed, waiting for takeContent()
+
+        float lastServerTime_ = 0.f;
+        float lastLoadTime_ = 0.f;
+        float lastTotalTime_ = 0.f;
+    };
+}
@@ -22,6 +22,7 @@
 #include "Cursor.hpp"
 
 #include <components/Animator.hpp>
+#include <components/TextureCache.hpp>
 
 #include <imgui.h>
 #include <SFML/Window/Mouse.hpp>
@@ -32,7 +33,7 @@ Cursor::Cursor()
 : animator_(std::make_unique<Animator>())
 , currentAnimation_("default")
 {
-    texture_.loadFromFile("cursors.png");
+    TextureCache::loadTexture("cursors.png", texture_);
     setTexture(texture_);
     setTextureRect(sf::IntRect(2, 4, 23, 23));
 
@@ -0,0 +1,325 @@
+// Copyright (c) 2022 Javier Castro - jcastro0x@gmail.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject to
+// the following conditions:
+//
+// The above copyright notice and this permission notice shall be
+// included in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+// LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+// WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// Compile rooms.json into the binary room database read by RoomDatabase.
+// Usage: RoomCompiler <rooms.json> <rooms.bin>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include <components/Hash.hpp>
+#include <scenes/world/room/RoomFormat.hpp>
+
+using namespace lpm;
+
+namespace
+{
+    /**
+     * Builds one room block. Arrays are reserved before the records pointing to them are written, strings go to the
+     * pool appended at the end.
+     */
+    class BlockWriter
+    {
+    public:
+        template<typename Record>
+        uint32_t reserve(size_t count)
+        {
+            align(4);
+            const auto offset = static_cast<uint32_t>(data_.size());
+            data_.resize(data_.size() + count * sizeof(Record));
+            return offset;
+        }
+
+        template<typename Record>
+        void write(uint32_t offset, size_t index, const Record& record)
+        {
+            std::memcpy(data_.data() + offset + index * sizeof(Record), &record, sizeof(Record));
+        }
+
+        RoomFormat::String addString(std::string_view string)
+        {
+            // Rooms repeat cursors, scripts and animation names a lot
+            if(const auto found = strings_.find(string); !string.empty() && found != std::string::npos)
+            {
+                return { static_cast<uint32_t>(found), static_cast<uint32_t>(string.size()) };
+            }
+
+            const auto offset = static_cast<uint32_t>(strings_.size());
+            strings_ += string;
+            return { offset, static_cast<uint32_t>(string.size()) };
+        }
+
+        /**
+         * Append string pool and patch the room record
+         */
+        std::vector<uint8_t> finish(RoomFormat::Room room)
+        {
+            align(4);
+            room.stringsOffset = static_cast<uint32_t>(data_.size());
+            room.stringsSize   = static_cast<uint32_t>(strings_.size());
+            data_.insert(data_.end(), strings_.begin(), strings_.end());
+            write(0, 0, room);
+            return std::move(data_);
+        }
+
+    private:
+        void align(size_t alignment)
+        {
+            data_.resize((data_.size() + alignment - 1) / alignment * alignment);
+        }
+
+    private:
+        std::vector<uint8_t> data_;
+        std::string strings_;
+    };
+
+    std::string getString(const nlohmann::json& json, const char* key)
+    {
+        const auto it = json.find(key);
+        return it != json.end() && it->is_string() ? it->get<std::string>() : std::string();
+    }
+
+    template<typename Type>
+    Type getNumber(const nlohmann::json& json, const char* key, Type fallback = {})
+    {
+        const auto it = json.find(key);
+        return it != json.end() && it->is_number() ? it->get<Type>() : fallback;
+    }
+
+    const nlohmann::json& getArray(const nlohmann::json& json, const char* key)
+    {
+        static const nlohmann::json EMPTY = nlohmann::json::array();
+        const auto it = json.find(key);
+        return it != json.end() && it->is_array() ? *it : EMPTY;
+    }
+
+    /**
+     * Masks are optional and named after the background: AL_Almacen1.jpg -> AL_Almacen1_Mask.png
+     */
+    std::string findMask(const std::filesystem::path& directory, const std::string& background)
+    {
+        auto mask = std::filesystem::path(background);
+        mask.replace_filename(mask.stem().string() + "_Mask.png");
+        return std::filesystem::exists(directory / mask) ? mask.generic_string() : std::string();
+    }
+
+    RoomFormat::Animation writeAnimation(BlockWriter& writer, const nlohmann::json& json)
+    {
+        const auto name     = getString(json, "name");
+        const auto& frames  = getArray(json, "frames");
+        const auto position = json.value("position", nlohmann::json::object());
+
+        RoomFormat::Animation animation {};
+        animation.nameHash     = hashName(name);
+        animation.name         = writer.addString(name);
+        animation.source       = writer.addString(getString(json, "source"));
+        animation.rate         = getNumber<float>(json, "rate", 1.f);
+        animation.posX         = getNumber<int32_t>(position, "x");
+        animation.posY         = getNumber<int32_t>(position, "y");
+        animation.frameCount   = static_cast<uint32_t>(frames.size());
+        animation.framesOffset = writer.reserve<RoomFormat::Frame>(frames.size());
+
+        for(size_t i = 0; i < frames.size(); i++)
+        {
+            const auto& frame = frames[i];
+            writer.write(animation.framesOffset, i, RoomFormat::Frame{
+                getNumber<uint16_t>(frame, "x"), getNumber<uint16_t>(frame, "y"),
+                getNumber<uint16_t>(frame, "w"), getNumber<uint16_t>(frame, "h")
+            });
+        }
+        return animation;
+    }
+
+    RoomFormat::Area writeArea(BlockWriter& writer, const nlohmann::json& json)
+    {
+        const auto& vertices = getArray(json, "vertices");
+        const auto script    = json.value("script", nlohmann::json::object());
+        const auto& params   = getArray(script, "params");
+        const auto debug     = json.value("debug", nlohmann::json::object());
+
+        RoomFormat::Area area {};
+        area.cursor         = writer.addString(getString(json, "cursor"));
+        area.script         = writer.addString(getString(script, "name"));
+        area.debugColor     = getNumber<uint32_t>(debug, "color");
+        area.comment        = writer.addString(getString(debug, "comment"));
+        area.vertexCount    = static_cast<uint32_t>(vertices.size());
+        area.verticesOffset = writer.reserve<RoomFormat::Vertex>(vertices.size());
+        area.paramCount     = static_cast<uint32_t>(params.size());
+        area.paramsOffset   = writer.reserve<RoomFormat::String>(params.size());
+
+        for(size_t i = 0; i < vertices.size(); i++)
+        {
+            writer.write(area.verticesOffset, i, RoomFormat::Vertex{ getNumber<uint16_t>(vertices[i], "x"), getNumber<uint16_t>(vertices[i], "y") });
+        }
+
+        for(size_t i = 0; i < params.size(); i++)
+        {
+            // Params are strings for now, keep any other value as its JSON text
+            const auto param = params[i].is_string() ? params[i].get<std::string>() : params[i].dump();
+            writer.write(area.paramsOffset, i, writer.addString(param));
+        }
+        return area;
+    }
+
+    RoomFormat::Camera writeCamera(BlockWriter& writer, const nlohmann::json& json, const std::filesystem::path& directory)
+    {
+        const auto name        = getString(json, "name");
+        const auto source      = json.value("source", nlohmann::json::object());
+        const auto& animations = getArray(json, "animations");
+        const auto& areas      = getArray(json, "areas");
+
+        RoomFormat::Camera camera {};
+        camera.nameHash         = hashName(name);
+        camera.name             = writer.addString(name);
+        camera.mask             = writer.addString(findMask(directory, name));
+        camera.sound            = writer.addString(getString(json, "background_sfx"));
+        camera.width            = getNumber<uint16_t>(source, "w");
+        camera.height           = getNumber<uint16_t>(source, "h");
+        camera.animationCount   = static_cast<uint32_t>(animations.size());
+        camera.animationsOffset = writer.reserve<RoomFormat::Animation>(animations.size());
+        camera.areaCount        = static_cast<uint32_t>(areas.size());
+        camera.areasOffset      = writer.reserve<RoomFormat::Area>(areas.size());
+
+        for(size_t i = 0; i < animations.size(); i++)
+        {
+            writer.write(camera.animationsOffset, i, writeAnimation(writer, animations[i]));
+        }
+
+        for(size_t i = 0; i < areas.size(); i++)
+        {
+            writer.write(camera.areasOffset, i, writeArea(writer, areas[i]));
+        }
+        return camera;
+    }
+
+    std::vector<uint8_t> writeRoom(const nlohmann::json& json, const std::filesystem::path& directory)
+    {
+        BlockWriter writer;
+        writer.reserve<RoomFormat::Room>(1);
+
+        const auto& cameras = getArray(json, "cameras");
+
+        RoomFormat::Room room {};
+        room.name          = writer.addString(getString(json, "name"));
+        room.music         = writer.addString(getString(json, "music"));
+        room.cameraCount   = static_cast<uint32_t>(cameras.size());
+        room.camerasOffset = writer.reserve<RoomFormat::Camera>(cameras.size());
+
+        for(size_t i = 0; i < cameras.size(); i++)
+        {
+            writer.write(room.camerasOffset, i, writeCamera(writer, cameras[i], directory));
+        }
+
+        return writer.finish(room);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if(argc != 3)
+    {
+        std::cerr << "Usage: RoomCompiler <rooms.json> <rooms.bin>\n";
+        return 1;
+    }
+
+    const std::filesystem::path input = argv[1];
+    std::ifstream in(input);
+    if(!in)
+    {
+        std::cerr << "Can't read \042" << input.string() << "\042\n";
+        return 1;
+    }
+
+    struct CompiledRoom
+    {
+        uint32_t nameHash;
+        std::string name;
+        std::vector<uint8_t> block;
+    };
+    std::vector<CompiledRoom> rooms;
+
+    try
+    {
+        const auto json = nlohmann::json::parse(in);
+        for(const auto& room : json)
+        {
+            const auto name = getString(room, "name");
+            rooms.push_back({ hashName(name), name, writeRoom(room, input.parent_path()) });
+        }
+    }
+    catch(const nlohmann::json::exception& e)
+    {
+        std::cerr << "Can't parse \042" << input.string() << "\042: " << e.what() << '\n';
+        return 1;
+    }
+
+    std::sort(rooms.begin(), rooms.end(), [](const auto& a, const auto& b){ return a.nameHash < b.nameHash; });
+    for(size_t i = 1; i < rooms.size(); i++)
+    {
+        if(rooms[i].name == rooms[i - 1].name)
+        {
+            std::cerr << "Room \042" << rooms[i].name << "\042 is defined twice\n";
+            return 1;
+        }
+    }
+
+    // Header, index, then every room block aligned so blocks never share a record
+    auto alignBlock = [](size_t offset){ return (offset + RoomFormat::BLOCK_ALIGNMENT - 1) / RoomFormat::BLOCK_ALIGNMENT * RoomFormat::BLOCK_ALIGNMENT; };
+
+    RoomFormat::Header header {};
+    header.magic       = RoomFormat::MAGIC;
+    header.version     = RoomFormat::VERSION;
+    header.roomCount   = static_cast<uint32_t>(rooms.size());
+    header.indexOffset = sizeof(RoomFormat::Header);
+
+    std::vector<RoomFormat::RoomEntry> index;
+    size_t offset = alignBlock(header.indexOffset + rooms.size() * sizeof(RoomFormat::RoomEntry));
+    for(const auto& room : rooms)
+    {
+        index.push_back({ room.nameHash, static_cast<uint32_t>(offset), static_cast<uint32_t>(room.block.size()) });
+        offset = alignBlock(offset + room.block.size());
+    }
+
+    std::vector<char> file(offset, 0);
+    std::memcpy(file.data(), &header, sizeof(header));
+    std::memcpy(file.data() + header.indexOffset, index.data(), index.size() * sizeof(RoomFormat::RoomEntry));
+    for(size_t i = 0; i < rooms.size(); i++)
+    {
+        std::memcpy(file.data() + index[i].offset, rooms[i].block.data(), rooms[i].block.size());
+    }
+
+    std::ofstream out(argv[2], std::ios::binary);
+    if(!out.write(file.data(), static_cast<std::streamsize>(file.size())))
+    {
+        std::cerr << "Can't write \042" << argv[2] << "\042\n";
+        return 1;
+    }
+
+    std::cout << "Compiled " << rooms.size() << " rooms into \042" << argv[2] << "\042 (" << file.size() << " bytes)\n";
+    return 0;
+}